@@ -66,7 +66,8 @@ void FastScatter::Init(Function <bool(String)> OnFile, Function <void(String)> O
 						  .Add("rao_mean", "RAO from average")
 						  .Add("percentile", "Percentile (ratio)")
 						  .Add("weibull", "Weibull fitting percentile (ratio)")
-						  .Add("td", "Design tension (time, γmean, γdyn)");
+						  .Add("td", "Design tension (time, γmean, γdyn)")
+						  .Add("del", "Damage equivalent load (Wöhler m, [cycles])");
 	compare.dropOperations.Resizeable(false).Width(200);					  
 	compare.dropOperations.WhenAction = [&] {
 		String operation;
@@ -311,7 +312,7 @@ void FastScatterBase::Init(FastScatter *parent, Function <bool(String)> OnFile,
 	butLoad.Tip(t_("Loads FAST out/outb file")) << [&] {file.DoGo();};
 	butSaveAs <<= THISBACK(OnSaveAs);
 	butSaveAs.Tip(t_("Saves data file"));
-	dropFormat.Add(".out").Add(".csv").Add(".csv only selected");
+	dropFormat.Add(".out").Add(".outb").Add(".csv").Add(".csv only selected");
 	dropFormat.SetIndex(0);
 	
 	opTime <<= 0;
@@ -713,7 +714,9 @@ bool FastScatterBase::OnLoad0(String fileName0) {
 			justUpdate = true;
 		}
 		
-		FastOut &fout = left.dataFast[iff];
+		UArray<FastOut> loaded;				// Taken by left.dataFast only when the load is complete
+		FastOut &fout = loaded.Add();
+		fout.derived = true;
 		
 		fout.pointParams.Clear();
 		for (int r = 0; r < rightDown.arrayPoints.GetRowCount(); ++r) {
@@ -742,7 +745,13 @@ bool FastScatterBase::OnLoad0(String fileName0) {
 				return !progress.Canceled();
 			};
 			
-			ret = fout.Load(fileName, Status);
+			try {
+				RunJob([&](BackgroundJob::StatusFun Status) {
+					ret = fout.Load(fileName, Status);
+				}, Status, progress);
+			} catch (const Exc &e) {
+				ret = e;
+			}
 		}
 		if (!ret.IsEmpty()) {
 			BEM::PrintError(F(t_("Problem reading file '%s': %s"), ~file, ret));
@@ -757,6 +766,9 @@ bool FastScatterBase::OnLoad0(String fileName0) {
 			return false;
 		}
 		
+		left.ClearSources();			// The plotted data is replaced
+		left.dataFast.Set(iff, loaded.Detach(0));	// fout keeps its address, as pointParams point to it
+		
 		for (int r = 0; r < fout.pointParams.size(); ++r) {	// Update with points from elastodyn.dat
 			rightDown.arrayPoints.Set(r, 0, fout.pointParams[r].name);
 			rightDown.arrayPoints.Set(r, 1, fout.pointParams[r].pos.x);
@@ -824,6 +836,9 @@ void FastScatterBase::OnSaveAs() {
 		if (fileType == ".out") {
 			fs.Type(t_("OpenFAST .out format"), "*.out");
 			ext = ".out";
+		} else if (fileType == ".outb") {
+			fs.Type(t_("OpenFAST .outb binary format"), "*.outb");
+			ext = ".outb";
 		} else {
 			fs.Type(t_("CSV format"), ".csv");
 			ext = ".csv";
@@ -846,8 +861,8 @@ void FastScatterBase::OnSaveAs() {
 				return !progress.Canceled();
 			};
 			
-			if (fileType == ".out") {	
-				if (!left.dataFast[row].Save(fs.Get(), Status, ".out")) {
+			if (fileType == ".out" || fileType == ".outb") {	
+				if (!left.dataFast[row].Save(fs.Get(), Status, fileType)) {
 					BEM::PrintError(F("Problem saving '%s'", fileName));
 					return;
 				}
@@ -914,6 +929,8 @@ void FastScatterBase::ShowSelected(bool zoomtofit) {
 				left.AddScatter();
 		}
 		
+		left.ClearSources();
+		
 		for (int iff = 0; iff < scattersize; ++iff) {
 			auto &scat = left.scatter[iff];
 			auto &fast = left.dataFast[iff];
@@ -1025,7 +1042,6 @@ void FastScatterBase::ShowSelected(bool zoomtofit) {
 				if (numData <= 1) 
 					throw Exc(t_("Incorrect start or end times"));
 				
-				UVector<int> idsx, idsy, idsFixed;
 				for (int rw = 0; rw < leftSearch.arrayParams.GetCount(); ++rw) {
 					String param = Trim(leftSearch.arrayParams.Get(rw, 0));
 					if (!param.IsEmpty()) {
@@ -1035,7 +1051,9 @@ void FastScatterBase::ShowSelected(bool zoomtofit) {
 						else {
 							if (left.dataFast.size() > 1 && opLoad3 != 0)
 								param = F("%d.", iff+1) + param;
-							scat.AddSeries(fast.dataOut, 0, col, idsx, idsy, idsFixed, false, idBegin, numData, xfactor)
+							FastOutSource &src = left.AddSource(opLoad3 == 2 ? iff : 0);
+							src.Init(fast, col, idBegin, numData, xfactor);
+							scat.AddSeries(src)
 								.NoMark().Legend(param).Units(fast.units[col], unitsx).Stroke(1);	
 						}
 					}
@@ -1049,7 +1067,9 @@ void FastScatterBase::ShowSelected(bool zoomtofit) {
 						else {
 							if (left.dataFast.size() > 1 && opLoad3 != 0)
 								param = F("%d.", iff+1) + param;
-							scat.AddSeries(fast.dataOut, 0, col, idsx, idsy, idsFixed, false, idBegin, numData, xfactor)
+							FastOutSource &src = left.AddSource(opLoad3 == 2 ? iff : 0);
+							src.Init(fast, col, idBegin, numData, xfactor);
+							scat.AddSeries(src)
 								.NoMark().Legend(param).Units(fast.units[col], unitsx).SetDataSecondaryY().Stroke(1);	
 						}
 					}
@@ -1064,6 +1084,7 @@ void FastScatterBase::ShowSelected(bool zoomtofit) {
 				scat.ZoomToFit(true, true);	
 			}
 		}
+		left.OnView();
 		
 		SaveParams();
 	} catch (const Exc &e) {
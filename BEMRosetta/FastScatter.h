@@ -23,6 +23,7 @@ public:
 		Add(box.SizePos());
 	}
 	void ClearScatter() {
+		ClearSources();
 		scatter.Clear();
 		box.Clear();
 	}
@@ -31,8 +32,25 @@ public:
 		s.ShowAllMenus().SetMode(ScatterDraw::MD_DRAW);
 		if (scatter.size() > 1)
 			s.LinkedWith(scatter[0]);
+		s.WhenZoomScroll << [this] {OnView();};
 		box.Add(s, box.GetRows(), 0);
 	}
+	FastOutSource &AddSource(int idScatter) {
+		plotScatter << idScatter;
+		return plotSource.Add();
+	}
+	void ClearSources() {
+		for (ScatterCtrl &s : scatter)
+			s.RemoveAllSeries();
+		plotSource.Clear();
+		plotScatter.Clear();
+	}
+	void OnView() {			// Series are decimated to the visible range
+		for (int i = 0; i < plotSource.size(); ++i) {
+			ScatterCtrl &s = scatter[plotScatter[i]];
+			plotSource[i].SetView(s.GetXMin(), s.GetXMin() + s.GetXRange(), max(1, s.GetSize().cx));
+		}
+	}
 	int AddAll(bool addScatter) {
 		dataFast.Add();
 		dataSource.Add();
@@ -63,7 +81,7 @@ public:
 		void Init(FastOut &_datafast, int _col)	{datafast = &_datafast;	col = _col;};	
 		Value Format(const Value& q) const {
 			ASSERT(datafast);
-			return datafast->dataOut[col][q];
+			return datafast->GetVal(int(q), col);
 		}
 	private:
 		FastOut *datafast;
@@ -78,6 +96,8 @@ public:
 	
 private:
 	Box box;
+	UArray<FastOutSource> plotSource;
+	UVector<int> plotScatter;		// Scatter of each plotSource
 };
 
 class FastScatterBase : public WithScatterBase<StaticRect> {
@@ -234,6 +234,9 @@ private:
 
 const Color &GetColorId(int id);
 
+// Runs task in a BackgroundJob, with Status called in the GUI thread. Throws if the task fails or is cancelled
+void RunJob(BackgroundJob::Task task, BackgroundJob::StatusFun Status, Progress &progress);
+
 Eigen::MatrixXd GridCtrlToMatrixXd(const GridCtrl &grid);
 void MatrixXdToGridCtrl(GridCtrl &grid, const Eigen::MatrixXd &mat, int rows, int cols, double val);
 void VectorToGridCtrl(GridCtrl &grid, const Upp::Vector<double> &mat, int rows, double val);
@@ -34,9 +34,25 @@ FreqSelector::FreqSelector() {
 };
 
 void Main::Init(bool firstTime) {
-	BEM::Print 	  	  = [this](String s) {printf("%s", ~s); mainOutput.Print(s);};
-	BEM::PrintWarning = [this](String s) {printf("%s", ~s); mainOutput.Print(s); /*Status(s);*/};
-	BEM::PrintError   = [this](String s) {printf("%s", ~s); /*tab.Set(mainOutput); */Status(s);	Exclamation(DeQtfLf(s));};
+	// Messages from a BackgroundJob are shown when the GUI thread processes the events
+	BEM::Print 	  	  = [this](String s) {
+		if (!Thread::IsMain()) {
+			PostCallback([=] {BEM::Print(s);});
+			return;
+		}
+		printf("%s", ~s); mainOutput.Print(s);};
+	BEM::PrintWarning = [this](String s) {
+		if (!Thread::IsMain()) {
+			PostCallback([=] {BEM::PrintWarning(s);});
+			return;
+		}
+		printf("%s", ~s); mainOutput.Print(s); /*Status(s);*/};
+	BEM::PrintError   = [this](String s) {
+		if (!Thread::IsMain()) {
+			PostCallback([=] {BEM::PrintError(s);});
+			return;
+		}
+		printf("%s", ~s); /*tab.Set(mainOutput); */Status(s);	Exclamation(DeQtfLf(s));};
 	
 	EM().Log("Init");
 	Sizeable().Zoomable().SetMinSize(Size(800, 600));
@@ -333,6 +349,15 @@ Main &Ma(Main *m) {
 
 void Status(String str, int time)	{Ma().Status(str, time);}
 
+void RunJob(BackgroundJob::Task task, BackgroundJob::StatusFun Status, Progress &progress) {
+	BackgroundJob job;
+	job.Run(pick(task), Status, [&] {
+		GuiSleep(20);				// Releases the GUI lock, so that the window is repainted
+		if (progress.Canceled())	// It also processes the events
+			job.Cancel();
+	});
+}
+
 String TabText(const TabCtrl &tab) {
 	int id = tab.Get();
 	if (id < 0)
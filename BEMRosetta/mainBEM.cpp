@@ -855,13 +855,17 @@ bool MainBEM::OnLoadFile(String file) {
 		
 		WaitCursor wait;
 		
-		int num = Bem().LoadBEM(file, [&](String str, int _pos) {
+		UArray<Hydro> loaded;				// Taken by Bem() only when the load is complete
+		RunJob([&](BackgroundJob::StatusFun Status) {
+			Hydro::LoadHydro(loaded, file, Status);
+		}, [&](String str, int _pos) {
 			progress.SetText(str); 
 			progress.SetPos(_pos); 
 	str.Replace("\n", "");
 	EM().Log(str);
 			return !progress.Canceled();
-		}, false);
+		}, progress);
+		int num = Bem().AddBEM(loaded);
 		
 		//int id = Bem().hydros.size()-1;
 		for (int idx = Bem().hydros.size() - num; idx < Bem().hydros.size(); ++idx) {
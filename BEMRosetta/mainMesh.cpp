@@ -949,11 +949,16 @@ bool MainBody::OnLoad() {
 		
 		WaitCursor waitcursor;
 
-		int num = Bem().LoadBody(file, [&](String str, int _pos) {
+		UArray<Body> meshes;				// Taken by Bem() only when the load is complete
+		bool clean = ~menuOpen.opClean;
+		RunJob([&](BackgroundJob::StatusFun Status) {
+			Bem().LoadBody(meshes, file, Status, clean);
+		}, [&](String str, int _pos) {
 			progress.SetText(str); 
 			progress.SetPos(_pos); 
 			return !progress.Canceled();
-		}, ~menuOpen.opClean, false);
+		}, progress);
+		int num = Bem().AddBody(meshes);
 		
 		menuAnimation.animationFile <<= Bem().fast.GetFileName();
 		
@@ -1917,7 +1922,15 @@ void MainBody::OnHealing(bool basic) {
 		Progress progress(t_("Healing mesh file..."), 100); 
 		mainView.surf.Disable();
 		
-		Bem().HealingBody(idx, basic, [&](String str, int _pos) {progress.SetText(str); progress.SetPos(_pos); return progress.Canceled();});
+		Body healed = clone(Bem().surfs[idx]);		// The view keeps showing the original until the end
+		RunJob([&](BackgroundJob::StatusFun Status) {
+			Bem().HealingBody(healed, basic, Status);
+		}, [&](String str, int _pos) {
+			progress.SetText(str); 
+			progress.SetPos(_pos); 
+			return !progress.Canceled();
+		}, progress);
+		Bem().surfs[idx] = pick(healed);
 		
 		menuPlot.showSkewed = true;
 		menuPlot.showFissure = true;
@@ -2943,11 +2956,16 @@ void MainGZ::OnUpdate() {
 			UVector<double> vol, disp, wett, wplane, draft;
 			UVector<Point3D> cb, cg;
 			
-			msh.GZ(~edFrom, ~edTo, ~edDelta, angle, Bem().rho, Bem().g, double(~edTolerance)/100., 
-				[&](String, int pos)->bool {
-					progress.SetPos(pos + 100*iangle);
-					return !progress.Canceled();
-				}, dangle, dgz, dMoment, vol, disp, wett, wplane, draft, cb, cg, errors, zA, zB, zC);
+			double from = ~edFrom, to = ~edTo, delta = ~edDelta, tolerance = double(~edTolerance)/100.;
+			UVector<double> angles;		// dangle is already plotted
+			RunJob([&](BackgroundJob::StatusFun Status) {		// msh is not changed, as GZ works on a copy
+				msh.GZ(from, to, delta, angle, Bem().rho, Bem().g, tolerance, Status, 
+					angles, dgz, dMoment, vol, disp, wett, wplane, draft, cb, cg, errors, zA, zB, zC);
+			}, [&](String, int pos)->bool {
+				progress.SetPos(pos + 100*iangle);
+				return !progress.Canceled();
+			}, progress);
+			dangle = pick(angles);
 			
 			Upp::Color color = ScatterDraw::GetNewColor(iangle);
 			
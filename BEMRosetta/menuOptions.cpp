@@ -81,6 +81,8 @@ void MenuOptions::Load() {
 	windowTitle <<= bem->windowTitle;
 	opT <<= bem->opT;
 	opNoWind <<= bem->opNoWind;
+	opH5Compressed <<= bem->opH5Compressed;
+	opCache <<= bem->opCache;
 	
 	dofType.SetIndex(bem->dofType);
 	headingType.SetIndex(bem->headingType);
@@ -137,6 +139,8 @@ void MenuOptions::OnSave() {
 		bem->windowTitle = ~windowTitle;
 		bem->opT = ~opT;
 		bem->opNoWind = ~opNoWind;
+		bem->opH5Compressed = ~opH5Compressed;
+		bem->opCache = ~opCache;
 		
 		bem->dofType = BasicBEM::DOFType(dofType.GetIndex());
 		bem->headingType = BasicBEM::HeadingType(headingType.GetIndex());
@@ -224,6 +228,10 @@ bool MenuOptions::IsChanged() {
 		return true;
 	if (bem->opNoWind != ~opNoWind)
 		return true;
+	if (bem->opH5Compressed != ~opH5Compressed)
+		return true;
+	if (bem->opCache != ~opCache)
+		return true;
 							
 	return false;
 }
\ No newline at end of file
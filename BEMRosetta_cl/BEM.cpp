@@ -69,7 +69,15 @@ int BEM::LoadBEM(String fileName, Function <bool(String, int)> Status, bool chec
 		}
 	}
 	
-	int num = Hydro::LoadHydro(hydros, fileName, Status);
+	UArray<Hydro> loaded;
+	Hydro::LoadHydro(loaded, fileName, Status);
+	
+	return AddBEM(loaded);
+}
+
+int BEM::AddBEM(UArray<Hydro> &loaded) {
+	int num = loaded.size();
+	hydros.AppendPick(pick(loaded));
 	
 	Bem().Nb = 0;
 	for (int i = 0; i < hydros.size(); ++i) 
@@ -102,6 +110,18 @@ Hydro &BEM::Join(UVector<int> &ids, Function <bool(String, int)> Status) {
 	return Last(hydros);
 }
 
+Hydro &BEM::JoinFiles(const UVector<String> &files, Function <bool(String, int)> Status) {
+	Hydro hy;
+	hy.JoinFiles(files, Status);
+	String error = hy.AfterLoad(Status);
+	if (!error.IsEmpty()) 
+		throw Exc(F(t_("Problem joining models: '%s'"), error));	
+	
+	hy.IncrementIdCount();
+	hydros << hy;
+	return Last(hydros);
+}
+
 void BEM::RemoveHydro(int id) {
 	if (id < 0)
 		return;
@@ -266,8 +286,6 @@ void BEM::MapMeshes(int idh, int ib, const UVector<int> &idms, bool oneCase) {
 }
 
 int BEM::LoadBody(String fileName, Function <bool(String, int pos)> Status, bool cleanPanels, bool checkDuplicated, int idFrom) {
-	Status(F(t_("Loading mesh '%s'"), fileName), 10);
-	
 	if (checkDuplicated) {
 		for (int i = 0; i < surfs.size(); ++i) {
 			if (surfs[i].dt.fileName == fileName) {
@@ -277,11 +295,23 @@ int BEM::LoadBody(String fileName, Function <bool(String, int pos)> Status, bool
 		}
 	}
 	UArray<Body> meshes;
+	LoadBody(meshes, fileName, Status, cleanPanels);
+	return AddBody(meshes, idFrom);
+}
+
+void BEM::LoadBody(UArray<Body> &meshes, String fileName, Function <bool(String, int pos)> Status, bool cleanPanels) const {
+	Status(F(t_("Loading mesh '%s'"), fileName), 10);
+	
+	TimeStop t;
 	String error = Body::Load(meshes, fileName, rho, g, cleanPanels, roundVal, roundEps);
 	if (!error.IsEmpty()) {
 		BEM::Print("\n" + F(t_("Problem loading '%s'") + F("\n%s"), fileName, error));
 		throw Exc(F(t_("Problem loading '%s'") + F("\n%s"), fileName, error));
 	}
+	Status(F(t_("Mesh '%s' loaded in %.3f s"), fileName, t.Seconds()), 100);
+}
+
+int BEM::AddBody(UArray<Body> &meshes, int idFrom) {
 	int num = meshes.size();
 	if (idFrom < 0)
 		idFrom = surfs.size();
@@ -289,8 +319,7 @@ int BEM::LoadBody(String fileName, Function <bool(String, int pos)> Status, bool
 	surfs.SetCount(max(surfs.size(), len));
 	for (int i = 0; i < num; ++i)
 		surfs[idFrom + i] = pick(meshes[i]);
-	
-	Status(F(t_("Mesh '%s' loaded"), fileName), 100);
+	meshes.Clear();
 	return num;
 }
 
@@ -331,14 +360,17 @@ void BEM::SaveBody(String fileName, const UVector<int> &ids, Body::MESH_FMT type
 }
 
 void BEM::HealingBody(int id, bool basic, Function <bool(String, int)> Status) {
-	Status(F(t_("Healing mesh '%s'"), surfs[id].dt.fileName), 10);
-	Print(F("\n\n") + F(t_("Healing mesh '%s'"), surfs[id].dt.fileName));
+	HealingBody(surfs[id], basic, Status);
+}
+
+void BEM::HealingBody(Body &body, bool basic, Function <bool(String, int)> Status) const {
+	Status(F(t_("Healing mesh '%s'"), body.dt.fileName), 10);
+	Print(F("\n\n") + F(t_("Healing mesh '%s'"), body.dt.fileName));
 	
 	String ret;
 	try {
-		ret = surfs[id].Heal(basic, rho, g, roundVal, roundEps, Status);
+		ret = body.Heal(basic, rho, g, roundVal, roundEps, Status);
 	} catch (Exc e) {
-		surfs.SetCount(surfs.size()-1);
 		Print("\n" + F(t_("Problem healing '%s': %s") + F("\n%s"), e));
 		throw std::move(e);
 	}
@@ -707,6 +739,10 @@ String BEM::LoadSerializeJson() {
 		opT = 0;
 	if (!ok || IsNull(opNoWind))
 		opNoWind = false;
+	if (!ok || IsNull(opH5Compressed))
+		opH5Compressed = false;
+	if (!ok || IsNull(opCache))
+		opCache = false;
 						
 	return ret;
 }
@@ -716,6 +752,26 @@ bool BEM::ClearTempFiles() {
 	DeleteFolderDeepWildcardsX(folder, "*.*");	Sleep(100);
 	return DirectoryCreateX(folder);
 }
+
+bool BEM::ClearCache() {
+	String folder = GetCacheFolder();
+	DeleteFolderDeepWildcardsX(folder, "*.*");	Sleep(100);
+	return DirectoryCreateX(folder);
+}
+
+String BEM::CacheReport() {
+	String folder = GetCacheFolder();
+	int num = 0;
+	int64 size = 0;
+	for (FindFile ff(AFX(folder, "*.bmrc")); ff; ff.Next()) {
+		if (ff.IsFile()) {
+			num++;
+			size += ff.GetLength();
+		}
+	}
+	return F(t_("Cache is %s. Folder '%s' has %d entries, %s. %d models loaded from it"), opCache ? t_("enabled") : t_("disabled"), 
+				folder, num, FormatFileSize(size), cacheHits);
+}
 	
 bool BEM::StoreSerializeJson() {
 	String folder = AFX(GetAppDataFolder(), "BEMRosetta");
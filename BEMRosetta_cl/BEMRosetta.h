@@ -37,6 +37,8 @@ public:
 };
 
 #include "FastOut.h"
+#include "job.h"
+#include "runner.h"
 
 
 class BEM;
@@ -119,6 +121,9 @@ public:
 	static String Load(UArray<Body> &mesh, String file, double rho, double g, bool cleanPanels, double grid, double eps);
 	static String Load(UArray<Body> &mesh, String file, double rho, double g, bool cleanPanels, double grid, double eps, bool &y0z, bool &x0z);
 	
+	enum DAT_PARSER {DAT_NEMOH, DAT_NEMOHFS, DAT_SALOME, DAT_WAMIT, DAT_DIODORE, DAT_AQWA, DAT_ANSYSTOAQWA, NUMDAT};
+	static UVector<int> SniffDat(String file);
+	
 	String Heal(bool basic, double rho, double g, double grid, double eps, Function <bool(String, int pos)> Status);
 	void GetBoundary();
 	void RemovePanels(const UVector<int> &panels, double rho, double g);
@@ -431,6 +436,8 @@ public:
     int GetHeadIdMD(const std::complex<double> &h) const;
 	
 	void BeforeSaveCase(String folderBase, int numCases, bool deleteFolder) const;
+	UVector<double> GetCaseCost(bool irregular, int qtfType) const;
+	UVector<int> GetCaseSets(int numCases, bool irregular, int qtfType) const;
     
     enum FORCE {NONE, ALL, SCATTERING, FK, QTFSUM, QTFDIF};
     
@@ -508,7 +515,11 @@ public:
     
     void SetC(int ib, const MatrixXd &K);
 	
-	String AfterLoad(Function <bool(String, int)> Status = Null);
+	String AfterLoad(Function <bool(String, int)> Status = Null, String cacheKey = Null);
+	
+	static String GetCacheKey(String file, int id);
+	bool LoadCache(String cacheKey);
+	void SaveCache(String cacheKey) const;
 	
 	void Initialize_AB(UArray<UArray<VectorXd>> &a, double val = NaNDouble);
 	void Initialize_ABpan(UArray<UArray<UArray<UArray<UArray<double>>>>> &a, double val = NaNDouble);
@@ -521,6 +532,7 @@ public:
 	void Dimensionalize_RAO(RAO &f);
 	void Add_Forces(Forces &to, const Hydro &hy, const Forces &from);
 	void Add_RAO(RAO &to, const Hydro &hy, const RAO &from);
+	void JoinAdd(const Hydro &hy);
 	void Symmetrize();
 	void GetFexFromFscFfk();
 	void GetFscFromFexFfk();
@@ -967,7 +979,7 @@ public:
 	String LoadSerialization(String file);
 	void SaveSerialization(String file) const;
 	
-	static int LoadHydro(UArray<Hydro> &hydro, String file, Function <bool(String, int)> Status);
+	static int LoadHydro(UArray<Hydro> &hydro, String file, Function <bool(String, int)> Status, bool afterLoad = true);	// If !afterLoad, the data is just read
 	
 	void LoadCase(String file, Function <bool(String, int)> Status = Null);
 	void SaveCase(String folder, BEM_FMT solver, bool x0z, bool y0z,
@@ -1203,6 +1215,13 @@ public:
 	void CopyQTF_MD();
 	
 	void Join(const UVector<Hydro *> &hydrosp);
+	// As Join(), but loading the models one at a time, so only the joined one and the one being added are in memory.
+	// A first pass gets the frequencies and headings, so the joined arrays are sized once
+	void JoinFiles(const UVector<String> &files, Function <bool(String, int)> Status = Null);
+	// Compares the time and peak data memory of Join() and JoinFiles(), and checks that the results match, 
+	// and that they match the unsplit model in fileRef if set
+	static String BenchmarkJoin(const UVector<String> &files, int &nf, String fileRef = Null);
+	int64 GetMemory() const;		// Bytes used by the radiation coefficients and the forces
 	
 	String S_g()	const {return !IsNum(dt.g)   ? F("-") : F("%.3f", dt.g);}
 	String S_h()	const {return !IsNum(dt.h)   ? F("-") : (dt.h < 0 ? F(t_("INFINITY")) : F("%.1f", dt.h));}
@@ -1873,6 +1892,7 @@ public:
 };
 
 UVector<int> NumSets(int num, int numsets);	
+UVector<int> CostSets(const UVector<double> &cost, int numsets);
 
 
 class LineParserWamit: public LineParser {
@@ -1929,6 +1949,12 @@ public:
 	int zeroIfEmpty = false;
 	bool opT = 0;
 	bool opNoWind = false;
+	bool opH5Compressed = false;
+	bool opCache = false;
+	String cacheFolder;			// If Null, the default one in AppData
+	int cacheHits = 0;			// Models that got the derived data from the cache
+	bool opCaseBalance = false;	// Split cases balancing their predicted load
+	String caseProfile;			// Optional frequency, time profile of a previous run
 	
 	String nemohPath, nemoh115Path, nemoh3Path, nemohPathGREN;
 	bool experimental;
@@ -1945,7 +1971,9 @@ public:
 	String windowTitle;
 
 	int LoadBEM(String file, Function <bool(String, int pos)> Status = Null, bool checkDuplicated = false);
+	int AddBEM(UArray<Hydro> &loaded);		// Takes the models from Hydro::LoadHydro(), as in a background load
 	Hydro &Join(UVector<int> &ids, Function <bool(String, int)> Status = Null);
+	Hydro &JoinFiles(const UVector<String> &files, Function <bool(String, int)> Status = Null);
 	void SymmetrizeForces(int id, bool xAxis);
 	void Symmetrize(int id);
 	void A0(int id);
@@ -1976,8 +2004,11 @@ public:
 	void FillFrequencyGapsQTFZero(int id);
 	
 	int LoadBody(String file, Function <bool(String, int pos)> Status, bool cleanPanels, bool checkDuplicated, int idFrom = -1);
+	void LoadBody(UArray<Body> &meshes, String file, Function <bool(String, int pos)> Status, bool cleanPanels) const;
+	int AddBody(UArray<Body> &meshes, int idFrom = -1);
 	void SaveBody(String fileName, const UVector<int> &ids, Body::MESH_FMT type, Body::MESH_TYPE meshType, bool symX, bool symY);
 	void HealingBody(int id, bool basic, Function <bool(String, int pos)> Status);
+	void HealingBody(Body &body, bool basic, Function <bool(String, int pos)> Status) const;
 	void OpeningsBody(int id);
 	void OrientSurface(int id, Function <bool(String, int)> Status);
 	void ImageBody(int id, int axis);
@@ -2003,6 +2034,9 @@ public:
 	bool StoreSerializeJson();
 	bool ClearTempFiles();
 	static String GetTempFilesFolder() {return AFX(GetAppDataFolder(), "BEMRosetta", "Temp");}
+	bool ClearCache();
+	String CacheReport();
+	String GetCacheFolder() const	{return IsNull(cacheFolder) ? AFX(GetAppDataFolder(), "BEMRosetta", "Cache") : cacheFolder;}
 	
 	void UpdateHeadAll();
 	void UpdateHeadAllMD();
@@ -2074,6 +2108,8 @@ public:
 			("opT", opT)
 			("hamsmrelPath", hamsmrelPath)
 			("opNoWind", opNoWind)
+			("opH5Compressed", opH5Compressed)
+			("opCache", opCache)
 		;
 		if (json.IsLoading()) {
 			dofType = BasicBEM::DOFType(idofType);
@@ -2231,7 +2267,15 @@ public:
 		lineTypes = clone(mooring.lineTypes);
 		lineProperties = clone(mooring.lineProperties);
 		connections = clone(mooring.connections);
+		pointIndex.Clear();
+	}
+	void Clear() {
+		lineTypes.Clear();
+		lineProperties.Clear();
+		connections.Clear();
+		pointIndex.Clear();
 	}
+	void ClearIndex()	{pointIndex.Clear();}		// To be called after changing the line points or the connections
 	
 	bool Load(String file);
 	bool LoadMoordyn(String file);
@@ -2317,7 +2361,7 @@ public:
 	};
 	UVector<Vessel> vessels;
 	
-	int FindVessel(const String &name) {
+	int FindVessel(const String &name) const {
 		for (int i = 0; i < vessels.size(); ++i) {
 			if (vessels[i].name == name)
 				return i;
@@ -2332,7 +2376,15 @@ public:
 	    int point2;
 	    double distance;
 	};		
-	bool FindClosest(ClosestInfo &info);
+	bool FindClosest(ClosestInfo &info, bool bruteForce = false);
+	static String BenchmarkClosest(int maxLines);
+	
+	// Mooring loads on vessel iv with the vessel displaced pos = (x, y, z, rx, ry, rz) [m, rad] from its position.
+	// Forces [N] and moments [N·m] are in global axes, referred to the displaced vessel origin
+	bool GetVesselLoads(int iv, const VectorXd &pos, VectorXd &f, double rho_water, double rho_m3 = 7850) const;
+	MatrixXd GetVesselLoads(int iv, const MatrixXd &pos, double rho_water, double rho_m3 = 7850) const;	// Each row is an offset. Solved in parallel
+	MatrixXd GetStiffness(int iv, double rho_water, double dpos = 0.1, double drot = 0.1*M_PI/180, double rho_m3 = 7850) const;
+	String BenchmarkLoads(int iv, double rho_water, int num);		// Compares GetVesselLoads() with the loads from Calc(), for num horizontal offsets
 	
 	double depth = Null;
 	double dtM = Null;
@@ -2342,15 +2394,38 @@ public:
 	double TmaxIC = Null;
 	double CdScaleIC = Null;
 	double threshIC = Null;
+
+private:
+	struct PointIndex {		// Uniform grid with the line points farther than 10 m from any connection. Built in FindClosest(), cleared when the points change
+		double cell = Null;
+		Point3D pmin;
+		int nx = 0, ny = 0, nz = 0;
+		UVector<Point3D> pos;
+		UVector<int> line, point;
+		VectorMap<int64, UVector<int>> cells;
+		
+		void Clear()			{cell = Null; pos.Clear(); line.Clear(); point.Clear(); cells.Clear();}
+		bool IsEmpty() const	{return IsNull(cell);}
+		void GetCell(const Point3D &p, int &ix, int &iy, int &iz) const {
+			ix = int((p.x - pmin.x)/cell);
+			iy = int((p.y - pmin.y)/cell);
+			iz = int((p.z - pmin.z)/cell);
+		}
+		static int64 Key(int ix, int iy, int iz) {return (int64(ix) << 42) | (int64(iy) << 21) | int64(iz);}
+	} pointIndex;
+	
+	void BuildIndex();
+	bool FindClosestBruteForce(ClosestInfo &info);
 };
 	
 class Wind {
 public:
-	String Load(String fileName, String ext = "");
+	String Load(String fileName, String ext = "", bool stream = false);
 	String Save(String fileName, String ext = "") const;
 	
 	const char *GetWindTypeStr() const;
 	const String &GetDescription() const	{return description;}
+	double GetDt() const					{return dt;}
 	void SetHubHeight(float h)			 	{zHub  = h;}
 	void SetGridHeight(float h)		 		{zGrid = h;	SetYZ();}
 	
@@ -2362,9 +2437,34 @@ public:
 	void SetFactor(float fu, float fv, float fw);
 	void SetFactor(int ic, float f);
 	
+	void BeginTransform();			// Following SetTI_*(), SetPowerLaw() and SetFactor() are queued...
+	bool ApplyTransform();			// ... and applied here in a single pass. Returns false if there was nothing to apply
+	bool IsTransformQueued() const			{return trA.size() > 0;}
+	String BenchmarkTransform(float pl, float zh, float factor, int &num);
+	double GetMaxDifference(const Wind &w) const;		// Highest difference of the grid velocities [m/s]. The grids have to be the same
+	
 	void GetPos(double z, double y, int &idz, int &idy);
-	VectorXd GetNorm(int idz, int idy);
-	VectorXd Get(int ic, int idz, int idy);
+	VectorXd GetNorm(int idz, int idy, int it0 = 0, int num = Null);
+	VectorXd Get(int ic, int idz, int idy, int it0 = 0, int num = Null);
+	
+	// Batched queries. Rows are the points, columns the times. If time is empty, all time steps are returned
+	MatrixXd Interpolate(int ic, const VectorXd &y, const VectorXd &z, const VectorXd &time) const;		// ic = -1 for the norm
+	MatrixXd GetRotorEquivalent(const VectorXd &y, const VectorXd &z, const VectorXd &radius, const VectorXd &yaw, 
+								const VectorXd &time, int nr = 5, int na = 16) const;
+	
+	struct Spectra {
+		int ic = 0, nfft = 0;
+		int iyRef = 0, izRef = 0;		// Reference point for the coherence
+		VectorXd freq;					// [Hz]
+		MatrixXd psd, coh;				// Rows are the frequencies and columns the grid points (iy + iz*ny). psd in [m²/s²/Hz], coh is the squared coherence
+		VectorXd variance, psdVariance, lengthScale;	// Per grid point. psdVariance is the integral of psd, to be compared with variance
+	};
+	void GetSpectra(Spectra &sp, int ic, int nfft = Null) const;
+	String SaveSpectra(String fileName, int ic, int nfft = Null) const;	// Saves <fileName>_psd.csv, _coh.csv and _stats.csv
+	static String BenchmarkSpectra(double u, double ti, double l, double &tiCalc, double &lCalc);
+	
+	bool IsStreamed() const					{return !!btsMap;}
+	void Expand();
 	
 	VectorXd GetTime();
 	int GetTimeId(double time);
@@ -2374,8 +2474,10 @@ public:
 protected:
 	String fileName; 
 	String description;
-	Tensor<double, 4> velocity;		// 4-D array: time, velocity component (1=U, 2=V, 3=W), iy, iz 
-	Tensor<double, 3> twrVelocity;	// 3-D array: time, velocity component, iz
+	// Velocities are kept in single precision. Saved .bts are quantised from these values, so they may differ 
+	// by one quantisation step from the ones saved from double precision fields
+	Tensor<float, 4> velocity;		// 4-D array: time, velocity component (1=U, 2=V, 3=W), iy, iz. Column major, so every point time series is contiguous
+	Tensor<float, 3> twrVelocity;	// 3-D array: time, velocity component, iz
 	VectorXd yPos;					// horizontal locations y(iy)
 	VectorXd zPos;					// vertical locations z(iz)
 	//VectorXd zTwr;				// vertical locations of tower points zTwr(iz)
@@ -2402,13 +2504,47 @@ protected:
     
     bool LHR = true;				// Default value for Bladed
     
+    One<FileMapping> btsMap;		// Streamed .bts. velocity is empty and values are decoded from the mapped file
+    const byte *btsData = nullptr;
+    int64 btsPos = 0;				// Position of the first time step
+    int btsSz = 0;					// Size of each value: 2 (int16) or 4 (float)
+    float btsSlope[3], btsOffset[3];
+    
+    float Vel(int it, int ic, int iy, int iz) const {
+    	if (!btsMap)
+    		return velocity(it, ic, iy, iz);
+    	return BTSValue((int64(it)*(ny*nz + ntwr) + int64(iz)*ny + iy)*3 + ic, ic);
+    }
+    float TwrVel(int it, int ic, int itw) const {
+    	if (!btsMap)
+    		return twrVelocity(it, ic, itw);
+    	return BTSValue((int64(it)*(ny*nz + ntwr) + int64(ny)*nz + itw)*3 + ic, ic);
+    }
+    float BTSValue(int64 id, int ic) const {
+    	const byte *p = btsData + btsPos + id*btsSz;
+    	float raw;
+    	if (btsSz == 2) {
+    		int16 v;
+    		memcpy(&v, p, sizeof(int16));
+    		raw = v;
+    	} else
+    		memcpy(&raw, p, sizeof(float));
+    	return (raw - btsOffset[ic])/btsSlope[ic];
+    }
+    
+    MatrixXf trA, trB;				// Queued transforms: v = trA(ic, iz)*v + trB(ic, iz)
+    UVector<bool> trUsed;			// Components with queued transforms
+    
     void SetYZ();
     void SetTI(int uvw, float ti, float &tiOld, float offset);
+    void Transform(int ic, const VectorXf &a, const VectorXf &b);
+    void GetSeries(int ic, double y, double z, ArrayXf &ret) const;
+    void GetTimeWeights(const VectorXd &time, ArrayXi &its, ArrayXf &wts) const;
 };
 
 class BTSWind : public Wind {
 public:
-	String LoadBTS(String file);
+	String LoadBTS(String file, bool stream = false);
 	String SaveBTS(String file, int fmtSz = -1) const;
 	
 private:
@@ -2420,8 +2556,8 @@ private:
     	int nv      = 3*nPts;               // the size of one time step
     	int nvTwr   = 3*ntwr;
     
-        velocity    = Tensor<double, 4>(nt,3,ny,nz);
-    	twrVelocity = Tensor<double, 3>(nt,3,ntwr);
+        velocity    = Tensor<float, 4>(nt,3,ny,nz);
+    	twrVelocity = Tensor<float, 3>(nt,3,ntwr);
   
 		Buffer<T> data(nv);
 		Buffer<T> datat(nvTwr);
@@ -2437,7 +2573,7 @@ private:
 	                    double d = (double(data[ip++]) - Voffset(k))/Vslope(k);
 	            		if (d > 200 || d < -200)
 	                        return t_("Wrong format");
-	                    velocity(it,k,iy,iz) = d;
+	                    velocity(it,k,iy,iz) = float(d);
 	                }
 	    		}
 	    	}
@@ -2450,7 +2586,7 @@ private:
 						double d = (double(datat[itw*3 + k]) - Voffset(k))/Vslope(k);
 						if (d > 500 || d < -500)
 							return t_("Wrong format");
-	                	twrVelocity(it,k,itw) = d; 
+	                	twrVelocity(it,k,itw) = float(d); 
 	                }
 	            }
 			}
@@ -2460,39 +2596,50 @@ private:
 	
 	void SaveBTSHeader(FileOutBinary &file, VectorXf &Vslope, VectorXf &Voffset, int fmtSz) const;
 	
+	void GetRange(VectorXd &mn, VectorXd &mx) const;
+	
+	// Quantises blocks of time steps in parallel and writes each block at once
 	template <class T>
 	void SaveBTSBody(FileOutBinary &file, const VectorXf &Vslope, const VectorXf &Voffset) const {
-		int nPts    = ny*nz;
-	    int nv      = 3*nPts;               // the size of one time step
+		int nv      = 3*ny*nz;              // the size of one time step
 	    int nvTwr   = 3*ntwr;
-	
-		Buffer<T> data(nv);
-		Buffer<T> datat(nvTwr);
-		int fmtSz = sizeof(T);
+		int nstep   = nv + nvTwr;
+		int ntBlock = minmax(int((8 << 20)/(sizeof(T)*nstep)), 1, nt);	// ~8 MB per write
 		
-		for (int it = 0; it < nt; ++it) {
-			int ip = 0;
-	        for (int iz = 0; iz < nz; ++iz) {
-	            for (int iy = 0; iy < ny; ++iy) {
-	                for (int k = 0; k < 3; ++k) {
-	                    data[ip++] = BetweenVal(T(velocity(it,k,iy,iz)*Vslope(k) + Voffset(k)),	
-	                    						std::numeric_limits<T>::lowest(),
-	                    						std::numeric_limits<T>::max());
-	                }
-	            }
-	        }			
-			file.Write(data.begin(), fmtSz*nv);
-
-			if (ntwr > 0) {
-	            for (int k = 0; k < 3; ++k)      // scale the data
-	                for (int itw = 0; itw < ntwr; ++itw) 
-	                    datat[itw*3 + k] = BetweenVal(T(fround(twrVelocity(it,k,itw)*Vslope(k) + Voffset(k))), 
-	                    						 	  std::numeric_limits<T>::lowest(), 
-	                    						 	  std::numeric_limits<T>::max());
-
-	            file.Write(datat.begin(), fmtSz*nvTwr);		// read the velocity components for the tower
+		const double slope[3]  = {Vslope(0), Vslope(1), Vslope(2)};
+		const double offset[3] = {Voffset(0), Voffset(1), Voffset(2)};
+		auto Quantise = [&](float v, int k) {
+			return BetweenVal(T(double(v)*slope[k] + offset[k]), std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max());
+		};
+		
+		Buffer<T> data(size_t(ntBlock)*nstep);
+		for (int it0 = 0; it0 < nt; it0 += ntBlock) {
+			int nb = min(ntBlock, nt - it0);
+			CoPartition(0, nz, [&](int iz0, int iz1) {
+				for (int iz = iz0; iz < iz1; ++iz) 
+					for (int iy = 0; iy < ny; ++iy) 
+						for (int k = 0; k < 3; ++k) {
+							T *d = data.begin() + (iz*ny + iy)*3 + k;
+							if (IsStreamed()) {
+								for (int it = 0; it < nb; ++it)
+									d[size_t(it)*nstep] = Quantise(Vel(it0 + it, k, iy, iz), k);
+							} else {
+								const float *v = &velocity(it0, k, iy, iz);		// Time series are contiguous
+								for (int it = 0; it < nb; ++it)
+									d[size_t(it)*nstep] = Quantise(v[it], k);
+							}
+						}
+			});
+			for (int it = 0; it < nb; ++it) {
+				T *d = data.begin() + size_t(it)*nstep + nv;
+				for (int itw = 0; itw < ntwr; ++itw)
+					for (int k = 0; k < 3; ++k) 
+	                    d[itw*3 + k] = BetweenVal(T(fround(double(TwrVel(it0 + it, k, itw))*Vslope(k) + Voffset(k))), 
+	                    						  std::numeric_limits<T>::lowest(), 
+	                    						  std::numeric_limits<T>::max());
 			}
-		}		
+			file.Write(data.begin(), sizeof(T)*size_t(nb)*nstep);
+		}
 	}
 };
 
@@ -2570,6 +2717,7 @@ struct BMR_Data {
 		
 	FastOut fast;
 	ArrayWind wind;
+	Mooring mooring;
 	
 	UVector<String> headParams;
 	int bemid = -1, bembodyid = -1, meshid = -1, windid = -1;		// Last valid id
@@ -106,12 +106,30 @@ void ShowHelp() {
 	Cout() << "\n" << t_("        depth  <depth>    # water depth   [m]     ") << Bem().depth;	
 	Cout() << "\n" << t_("-echo off/on              # Show text messages");
 	Cout() << "\n" << t_("-csvseparator <sep>       # Sets the separator for .csv files");
+	Cout() << "\n" << t_("-run <folder> <pattern> <command> [<options>] # Runs <command> for every <pattern> file in <folder> and subfolders, in its folder.");
+	Cout() << "\n" << t_("                          #   %file% and %threads% are replaced, and %bemrosetta% is this program. \"script\" runs the file.");
+	Cout() << "\n" << t_("                          #   A log of the ended cases lets an interrupted run resume. Prints the cases run");
+	Cout() << "\n" << t_("        jobs <num>        # Cases running at the same time");
+	Cout() << "\n" << t_("        threads <num>     # Threads per case");
+	Cout() << "\n" << t_("        affinity          # Pins every case to its own cores");
+	Cout() << "\n" << t_("        timeout <sec>     # Maximum time per case");
+	Cout() << "\n" << t_("        restart           # Runs again the cases already ended");
+	Cout() << "\n" << t_("-dummySolver <sec> [<file>] # Stands in for a solver: waits <sec> and saves <file>.dummy");
 	Cout() << "\n" << t_("-isEqual <value>          # Stops if last print is not equal to <value>");
 	Cout() << "\n" << t_("-isSimilar <value>        # Stops if <value> is not included in last print");
+	Cout() << "\n" << t_("-isEqualFile <file> <file> # Stops if the files are not equal byte by byte");
 	Cout() << "\n";
 	Cout() << "\n" << t_("-bem                      # The next commands are for BEM data");
 	Cout() << "\n" << t_("-i  -input <file>         # Load model");
+	Cout() << "\n" << t_("-cancelLoad <file> [<reports>] # Load model in background, cancelling it after <reports> progress reports (default 2). Prints the number of models");
+	Cout() << "\n" << t_("-join <file> <file> ...   # Join the models in the files, loading them one at a time");
+	Cout() << "\n" << t_("-benchJoin <file> <file> ... # Compares joining the models in memory and one at a time. Prints the frequencies");
+	Cout() << "\n" << t_("-benchJoinRef <unsplit> <file> <file> ... # As -benchJoin, also checking that the joined model matches the unsplit one");
 	Cout() << "\n" << t_("-save -c  -convert <file> # Export actual model to output file");
+	Cout() << "\n" << t_("-h5compressed <yes/no>    # BEMIO .h5 saved with chunked and compressed full arrays, without components");
+	Cout() << "\n" << t_("-cache <yes/no/clear/report> # Reuse Kirf, A∞, A∞(ω) and potentials data from a cache when loading the same files");
+	Cout() << "\n" << t_("                          #   report prints the number of models loaded from the cache");
+	Cout() << "\n" << t_("-cache folder <folder>    # Use <folder> for the cache instead of the default one");
 	Cout() << "\n" << t_("-cl -clear                # Clear loaded models");
 	Cout() << "\n" << t_("-saveCase                 # Saves a folder with the BEM case files ready to be calculated");
 	Cout() << "\n" << t_("   folder <folder>        # Folder name");
@@ -128,6 +146,10 @@ void ShowHelp() {
 	Cout() << "\n" << t_("   qtfMiddle/qtfControl   # Include QTF Control Surface/Middle field in output files");
 	Cout() << "\n" << t_("   qtfMiddle/qtfControl   # Include QTF Control Surface/Middle field in output files");
 	Cout() << "\n" << t_("   qtfAutoMesh <yes/no>   # Auto generates Control Surface mesh");	
+	Cout() << "\n" << t_("   split <num>            # Split frequencies in <num> cases (Nemoh, Capytaine and HAMS)");
+	Cout() << "\n" << t_("   balance                # Split cases balancing their predicted load instead of their number of frequencies");
+	Cout() << "\n" << t_("   profile <file>         # Balance split cases using a frequency, time [s] profile of a previous run");
+	Cout() << "\n" << t_("-caseSets <num> [profile <file>] # Prints the frequencies of each of <num> cases balancing their predicted load");
 	Cout() << "\n" << t_("-setid <id>                   # Set the id of the default BEM model");
 	Cout() << "\n" << t_("-setbodyid <id>               # Set the id of the default BEM model body");
 	Cout() << "\n" << t_("-params <param> <value>       # Set parameters:");
@@ -153,6 +175,7 @@ void ShowHelp() {
 	Cout() << "\n" << t_("               <h1> <h2>  # Indicated pair of headings [deg]");
 	Cout() << "\n" << t_("-delHead   <h1> ...       # Delete forces for indicated headings [deg]");
 	Cout() << "\n" << t_("-delHeadId <h1> ...       # Delete forces for indicated heading ids");
+	Cout() << "\n" << t_("-delFreqId <f1> ...       # Delete data for indicated frequency ids");
 	Cout() << "\n" << t_("-delButHead   <h1> ...    # Delete forces for all but indicated headings [deg]");
 	Cout() << "\n" << t_("-delButHeadId <h1> ...    # Delete forces for all but indicated heading ids");
 	Cout() << "\n" << t_("-delQTFHead   <h1> <h2> ..# Delete QTF for indicated pairs of headings [deg]");
@@ -227,19 +250,44 @@ void ShowHelp() {
 	Cout() << "\n" << t_("-cl -clear                      # Clear loaded models");
 	Cout() << "\n";
 	Cout() << "\n" << t_("-time                           # The next commands are for time series");
-	Cout() << "\n" << t_("-i  -input <file>               # Load file");
-	Cout() << "\n" << t_("-save -c  -convert <file> <params>    # Export actual model to output file. If <params>, only included params are saved. '*' allowed");
+	Cout() << "\n" << t_("-i  -input <file> <params>      # Load file. If <params>, only included params are loaded. '*' allowed");
+	Cout() << "\n" << t_("-save -c  -convert <file> <params>    # Export actual model to output file (.out, .outb, .csv). If <params>, only included params are saved. '*' allowed");
+	Cout() << "\n" << t_("-benchSave <folder>             # Times saving the loaded file in <folder> as .out, .csv and .outb. Checks .out and .csv against the row by row writer. Prints the number of channels loaded back from .outb");
+	Cout() << "\n" << t_("-sidecar <yes/no>               # Load the files from a binary copy saved next to them the first time they are parsed");
+	Cout() << "\n" << t_("-benchSidecar <file>            # Times loading <file> parsing it and from its binary copy. Prints the number of channels");
+	Cout() << "\n" << t_("-single <yes/no>                # Keep the loaded channels, except time, in single precision to halve the memory");
+	Cout() << "\n" << t_("-benchSingle <file>             # Compares memory and query times of <file> loaded in double and single precision. Prints the number of single precision channels");
+	Cout() << "\n" << t_("-derived                        # Calculates again the derived channels (platform tilt, blade tips, resultant loads, ...) of the loaded file. Prints their number");
+	Cout() << "\n" << t_("-benchDerived                   # Times the derived channels calculated sample by sample and by column blocks. Prints their number");
+	Cout() << "\n" << t_("-benchRainflow [<samples>]      # Checks the rainflow counting with the ASTM E1049 series and times it on <samples> samples. Prints the ASTM cycles found");
+	Cout() << "\n" << t_("-benchPlot <param> [<pixels>] [<from> <to>] # Times the decimated plot queries of <param> for <pixels> columns. Prints the plotted max, and the one zoomed from <from> to <to> [s]");
+	Cout() << "\n" << t_("-benchCases <file> [<cases>]    # Times setting the DLC variables of <cases> cases in HydroDyn <file>. Prints the identical files");
+	Cout() << "\n" << t_("-caseMatrix <seed> <folder> <file:var> <values> ...  # Creates in <folder> the cases of every combination of the comma separated <values> of the variables, as hydrodyn:WaveHs 2,4. Prints the number of cases");
+	Cout() << "\n" << t_("-stats <folder> <pattern> <csv> <param> <metrics> ... # Saves in <csv> the comma separated <metrics> of <param>, as FAIRTEN3 avg,max,percentile(0.9),");
+	Cout() << "\n" << t_("                                # of every file matching <pattern> in <folder> and its subfolders. The files are not kept in memory. Prints the number of files and the metrics of the first one");
+	Cout() << "\n" << t_("              threads <num>     # Number of files loaded at the same time. By default, the number of cores");
+	Cout() << "\n" << t_("              start <time> end <time> # Time range [s]");
 	Cout() << "\n" << t_("-p  -print <params>             # Prints file data in a row");
 	Cout() << "\n" << t_("     <params> list              # Parameter names");
 	Cout() << "\n" << t_("              <param> <time>    # Value of <param> in <time>");
 	Cout() << "\n" << t_("              <param> avg       # <param> avg");
 	Cout() << "\n" << t_("              <param> max       # <param> max");
 	Cout() << "\n" << t_("              <param> min       # <param> min");	
+	Cout() << "\n" << t_("              <param> del <m> [<neq>] # <param> damage equivalent load for Wöhler exponent <m> and <neq> cycles. By default, 1 Hz");
 	Cout() << "\n";
 	Cout() << "\n" << t_("-wind                           # The next commands are for wind series");
 	Cout() << "\n" << t_("-i  -input <file>               # Load file");
+	Cout() << "\n" << t_("-is -istream <file>             # Open .bts file decoding the data from disk only when needed");
 	Cout() << "\n" << t_("-save -c  -convert <file>       # Export actual model to output file");
 	Cout() << "\n" << t_("-setid <id>                     # Set the id of the default BEM model");
+	Cout() << "\n" << t_("-spectra <file> [<comp>] [<nfft>] # Saves in <file>_psd, _coh and _stats.csv the PSD, the coherence with the hub point,");
+	Cout() << "\n" << t_("                                #   the variance and the integral length scale of component <comp> (0 u, 1 v, 2 w) at every grid point");
+	Cout() << "\n" << t_("-benchSpectra <u> <ti> <l>      # Recovers TI [%] and length scale [m] from the spectra of a synthetic Kaimal field");
+	Cout() << "\n" << t_("                                #   of mean speed <u> [m/s], <ti> and <l>. Prints them");
+	Cout() << "\n" << t_("-compare <id> <tol>             # Stops if a velocity differs more than <tol> [m/s] from the one in model <id>. Prints the highest difference");
+	Cout() << "\n" << t_("-benchTransform <pl> <zh> <f>   # Compares applying power law <pl> at <zh>, TI and scale <f> one by one and queued. Prints the values");
+	Cout() << "\n" << t_("-interpolate <query> <file>     # Saves in <file> the velocity norm series at each \"y z\" row in <query>,");
+	Cout() << "\n" << t_("                                #   or the rotor equivalent velocity if rows are \"y z radius yaw\"");
 	Cout() << "\n" << t_("-params <param> <value/s>       # Set parameters:");
 	Cout() << "\n" << t_("        hubheight               # Hub heignt [m]       ");
 	Cout() << "\n" << t_("        gridheight              # Grid base height [m] ");
@@ -255,10 +303,20 @@ void ShowHelp() {
 	Cout() << "\n" << t_("        velComp <comp> <y> <z> <time> # Wind speed [m/s] for 0 (u), 1 (v), ... at y, z [m] in <time>");
 	Cout() << "\n" << t_("        velComp <comp> <y> <z> data   # Wind speed [m/s] for 0 (u), 1 (v), ... at y, z [m] data series");
 	Cout() << "\n" << t_("        velComp <comp> <y> <z> avg    # Wind speed [m/s] for 0 (u), 1 (v), ... at y, z [m] average");
+	Cout() << "\n" << t_("        velInterp <y> <z> <time>/data/avg  # Wind speed norm [m/s] interpolated at any y, z [m]");
+	Cout() << "\n" << t_("        rews <y> <z> <r> <yaw> <time>/data/avg # Rotor equivalent wind speed [m/s] of a rotor centred at y, z [m] with radius r [m] and yaw [deg]");
 	
 	Cout() << "\n" << t_("-r  -report                     # Output loaded model main data");
 	Cout() << "\n" << t_("-ra -reportall                  # Output all models main data");
 	Cout() << "\n" << t_("-cl -clear                      # Clear loaded models");	
+	Cout() << "\n";
+	Cout() << "\n" << t_("-mooring                        # The next commands are for mooring");
+	Cout() << "\n" << t_("-i  -input <file>               # Load mooring .json file");
+	Cout() << "\n" << t_("-stiffness [<vessel>]           # Prints the linearised 6x6 mooring stiffness matrix of <vessel> (default the first one)");
+	Cout() << "\n" << t_("-benchLoads <num> [<vessel>]    # Times the loads on <vessel> for <num> horizontal offsets, checking them against the lines solved by -i");
+	Cout() << "\n" << t_("-sweep <dof> <from> <to> <num> <file> [<vessel>] # Saves in <file> the mooring loads for <num> offsets in <dof> (1 to 6)");
+	Cout() << "\n" << t_("                                #   from <from> to <to> [m, deg]");
+	Cout() << "\n" << t_("-benchMooring <lines>           # Compares the closest mooring line search with brute force, up to <lines>");
 	
 #ifdef PLATFORM_WIN32
 	Cout() << "\n";
@@ -312,7 +370,7 @@ bool BMR_Data::ConsoleMain(const UVector<String>& _command, bool gui) {
 	bool returnval = true;
 	String lastPrint;
 	
-	const Upp::Index<String> mainCommands = {"-general", "-bem", "-mesh", "-fast", "-time", "-orca", "-wind", "-h", "-help", "-paramfile"};
+	const Upp::Index<String> mainCommands = {"-general", "-bem", "-mesh", "-fast", "-time", "-orca", "-wind", "-mooring", "-h", "-help", "-paramfile"};
 	
 	try {
 		if (command.IsEmpty()) {
@@ -335,6 +393,8 @@ bool BMR_Data::ConsoleMain(const UVector<String>& _command, bool gui) {
 					nextcommands = "orca";
 				else if (param == "-wind") 
 					nextcommands = "wind";
+				else if (param == "-mooring") 
+					nextcommands = "mooring";
 				else if (param == "-h" || param == "-help") {
 					ShowHelp();
 					break;
@@ -356,6 +416,17 @@ bool BMR_Data::ConsoleMain(const UVector<String>& _command, bool gui) {
 						BEM::Print("\n" + F(t_("Last print is equal to \"%s\""), data));
 					else
 						throw Exc(F(t_("Last print is not equal to \"%s\""), data));
+				} else if (param == "-isequalfile") { 
+					CheckIfAvailableArg(command, ++ic, "-isEqualFile 1st file");
+					String file1 = FileName(command[ic]);
+					CheckIfAvailableArg(command, ++ic, "-isEqualFile 2nd file");
+					String file2 = FileName(command[ic]);
+					for (String file : {file1, file2})
+						if (!FileExists(file)) 
+							throw Exc(F(t_("File '%s' not found"), file));
+					if (LoadFile(file1) != LoadFile(file2))
+						throw Exc(F(t_("Files '%s' and '%s' are not equal"), file1, file2));
+					BEM::Print("\n" + F(t_("Files '%s' and '%s' are equal"), file1, file2));
 				} else if (param.StartsWith("-issimilar")) { 
 					CheckIfAvailableArg(command, ++ic, "-isSimilar");
 					
@@ -449,6 +520,61 @@ bool BMR_Data::ConsoleMain(const UVector<String>& _command, bool gui) {
 							String sep = ToLower(command[ic]);				
 							
 							ScatterDraw::SetDefaultCSVSeparator(sep);
+							Bem().csvSeparator = sep;		// As in the options, for all the .csv files
+						} else if (param == "-run") {
+							CheckIfAvailableArg(command, ++ic, "-run folder");
+							String folder = FileName(command[ic]);
+							CheckIfAvailableArg(command, ++ic, "-run pattern");
+							String pattern = command[ic];
+							CheckIfAvailableArg(command, ++ic, "-run command");
+							String cmd = command[ic];
+							cmd.Replace("%bemrosetta%", "\"" + GetExeFilePath() + "\"");
+							
+							CaseRunner runner;
+							while (command.size() > ic+1 && !command[ic+1].StartsWith("-")) {
+								ic++;
+								String pparam = ToLower(command[ic]);
+								if (pparam == "jobs") {
+									CheckIfAvailableArg(command, ++ic, "jobs");
+									runner.numJobs = ScanInt(command[ic]);
+									if (IsNull(runner.numJobs) || runner.numJobs < 1)
+										throw Exc(F(t_("Wrong argument '%s'"), command[ic]));
+								} else if (pparam == "threads") {
+									CheckIfAvailableArg(command, ++ic, "threads");
+									runner.numThreads = ScanInt(command[ic]);
+									if (IsNull(runner.numThreads) || runner.numThreads < 1)
+										throw Exc(F(t_("Wrong argument '%s'"), command[ic]));
+								} else if (pparam == "affinity")
+									runner.affinity = true;
+								else if (pparam == "timeout") {
+									CheckIfAvailableArg(command, ++ic, "timeout");
+									runner.timeout = ScanDouble(command[ic]);
+									if (IsNull(runner.timeout) || runner.timeout <= 0)
+										throw Exc(F(t_("Wrong argument '%s'"), command[ic]));
+								} else if (pparam == "restart")
+									runner.resume = false;
+								else
+									throw Exc(F(t_("Wrong command '%s'"), command[ic]));
+							}
+							String ret = runner.Run(folder, pattern, cmd, echo ? Status : NoPrint);
+							if (!ret.IsEmpty())
+								throw Exc(ret);
+							BEM::Print("\n" + runner.GetSummary());
+							lastPrint = FormatInt(runner.numRun);
+						} else if (param == "-dummysolver") {
+							CheckIfAvailableArg(command, ++ic, "-dummySolver");
+							double sec = ScanDouble(command[ic]);
+							if (IsNull(sec) || sec < 0)
+								throw Exc(F(t_("Wrong argument '%s'"), command[ic]));
+							String file;
+							if (command.size() > ic+1 && !command[ic+1].StartsWith("-")) {
+								file = FileName(command[++ic]);
+								if (!FileExists(file)) 
+									throw Exc(F(t_("File '%s' not found"), file));
+							}
+							Sleep(int(1000*sec));
+							if (!file.IsEmpty() && !SaveFile(file + ".dummy", F("Dummy solver run of '%s' for %.3f s", file, sec)))
+								throw Exc(F(t_("Impossible to save '%s'"), file + ".dummy"));
 						} else
 							throw Exc(F(t_("Unknown argument '%s'"), command[ic]));
 /*bem*/				} else if (nextcommands == "bem") {
@@ -460,10 +586,79 @@ bool BMR_Data::ConsoleMain(const UVector<String>& _command, bool gui) {
 								throw Exc(F(t_("File '%s' not found"), file)); 
 							
 							BEM::Print("\n");
-							Bem().LoadBEM(file, echo ? Status : NoPrint, false);
+							UArray<Hydro> loaded;		// Loaded in background, as in the GUI
+							BackgroundJob().Run([&](BackgroundJob::StatusFun Status) {
+								Hydro::LoadHydro(loaded, file, Status);
+							}, echo ? Status : NoPrint);
+							Bem().AddBEM(loaded);
 							bemid = Bem().hydros.size() - 1;
 							bembodyid = Bem().hydros[bemid].dt.msh.size() - 1;
 							BEM::Print("\n" + F(t_("File '%s' loaded"), file));
+						} else if (param == "-cancelload") {
+							CheckIfAvailableArg(command, ++ic, "-cancelLoad");
+							
+							String file = FileName(command[ic]);
+							if (!FileExists(file)) 
+								throw Exc(F(t_("File '%s' not found"), file)); 
+							
+							int reports = 2;
+							if (command.size() > ic+1 && !IsNull(ScanInt(command[ic+1]))) {
+								reports = ScanInt(command[++ic]);
+								if (reports < 1)
+									throw Exc(F(t_("Wrong number of progress reports '%s'"), command[ic]));
+							}
+							
+							UArray<Hydro> loaded;
+							BackgroundJob job;
+							std::atomic<int> numReports{0};
+							try {
+								job.Run([&](BackgroundJob::StatusFun Status) {
+									Hydro::LoadHydro(loaded, file, [&](String str, int pos) {
+										bool ret = Status(str, pos);
+										if (++numReports == reports) {	// The load waits to be cancelled, so it cannot end before
+											while (!job.IsCanceled())
+												Sleep(1);
+										}
+										return ret;
+									});
+								}, [&](String str, int pos) {
+									if (echo)
+										Status(str, pos);
+									return numReports < reports;	// Cancelled from this thread, as the GUI does
+								});
+								Bem().AddBEM(loaded);
+							} catch (const Exc &e) {
+								BEM::Print("\n" + F(t_("Loading '%s' stopped after %d progress reports: %s"), file, int(numReports), e));
+							}
+							lastPrint = FormatInt(Bem().hydros.size());
+							BEM::Print("\n" + F(t_("Loaded models: %s"), lastPrint));
+						} else if (param == "-join" || param == "-benchjoin" || param == "-benchjoinref") {
+							String fileRef;
+							if (param == "-benchjoinref") {
+								CheckIfAvailableArg(command, ++ic, "-benchJoinRef");
+								fileRef = FileName(command[ic]);
+								if (!FileExists(fileRef)) 
+									throw Exc(F(t_("File '%s' not found"), fileRef)); 
+							}
+							UVector<String> files;
+							while (command.size() > ic+1 && !command[ic+1].StartsWith("-")) {
+								String file = FileName(command[++ic]);
+								if (!FileExists(file)) 
+									throw Exc(F(t_("File '%s' not found"), file)); 
+								files << file;
+							}
+							if (files.size() < 2)
+								throw Exc(F(t_("'%s' requires at least two files"), command[ic]));
+							if (param == "-join") {
+								Bem().JoinFiles(files, echo ? Status : NoPrint);
+								bemid = Bem().hydros.size() - 1;
+								bembodyid = Bem().hydros[bemid].dt.msh.size() - 1;
+								BEM::Print("\n" + F(t_("%d files joined"), files.size()));
+							} else {
+								int nf;
+								BEM::Print("\n" + Hydro::BenchmarkJoin(files, nf, fileRef));
+								lastPrint = FormatInt(nf);
+							}
 						} else if (param == "-r" || param == "-report") {
 							if (Bem().hydros.IsEmpty()) 
 								throw Exc(t_("No file loaded"));
@@ -511,6 +706,31 @@ bool BMR_Data::ConsoleMain(const UVector<String>& _command, bool gui) {
 							BEM::Print("\n");
 							Bem().hydros[bemid].SaveAs(file, echo ? Status : NoPrint, Hydro::UNKNOWN, qtfHeading);
 							BEM::Print("\n" + F(t_("Model id %d saved as '%s'"), bemid, file));
+						} else if (param == "-h5compressed") {
+							CheckIfAvailableArg(command, ++ic, "-h5compressed");
+							
+							String val = ToLower(command[ic]);
+							BMR_BEMIO_Compressed_Set(val == "true" || val == "yes");
+							BEM::Print("\n" + F(t_("BEMIO .h5 compressed output is %s"), Bem().opH5Compressed ? t_("enabled") : t_("disabled")));
+						} else if (param == "-cache") {
+							CheckIfAvailableArg(command, ++ic, "-cache");
+							
+							String val = ToLower(command[ic]);
+							if (val == "clear") {
+								if (!Bem().ClearCache())
+									throw Exc(F(t_("Impossible to clear cache folder '%s'"), Bem().GetCacheFolder()));
+								BEM::Print(F("\n") + t_("Cache cleared"));
+							} else if (val == "report") {
+								BEM::Print("\n" + Bem().CacheReport());
+								lastPrint = FormatInt(Bem().cacheHits);
+							} else if (val == "folder") {
+								CheckIfAvailableArg(command, ++ic, "-cache folder");
+								Bem().cacheFolder = GetFullPath(FileName(command[ic]));
+								BEM::Print("\n" + F(t_("Cache folder is '%s'"), Bem().cacheFolder));
+							} else {
+								BMR_Cache_Set(val == "true" || val == "yes");
+								BEM::Print("\n" + F(t_("Cache is %s"), Bem().opCache ? t_("enabled") : t_("disabled")));
+							}
 						} else if (param == "-convqtfheads") {	
 							CheckIfAvailableArg(command, ++ic, "-convqtfheads");
 							if (ToLower(command[ic]) == "all") 
@@ -558,6 +778,21 @@ bool BMR_Data::ConsoleMain(const UVector<String>& _command, bool gui) {
 							}
 							hy.DeleteHeadings(ids);	
 							BEM::Print("\n" + F(t_("Headings deleted")));
+						} else if (param == "-delfreqid") {	
+							if (Bem().hydros.size() < bemid) 
+								throw Exc(F(t_("Model %d is not loaded"), bemid));
+							Hydro &hy = Bem().hydros[bemid];
+							UVector<int> ids;
+							int id;
+							while (ic+1 < command.size() && !IsNull(id = ScanInt(command[ic+1]))) {
+								if (id < 0 || id >= hy.dt.w.size())
+									throw Exc(F(t_("Wrong frequency id '%s'"), command[ic+1]));
+								FindAdd(ids, id);
+								ic++;
+							}
+							Sort(ids);
+							hy.DeleteFrequencies(ids);	
+							BEM::Print("\n" + F(t_("Frequencies deleted")));
 						} else if (param == "-delbuthead") {
 							if (Bem().hydros.size() < bemid) 
 								throw Exc(F(t_("Model %d is not loaded"), bemid));
@@ -724,6 +959,8 @@ bool BMR_Data::ConsoleMain(const UVector<String>& _command, bool gui) {
 							String qtfType;
 							bool autoQTF = false;
 							int numCases = 0, numThreads = 0;
+							bool balance = false;
+							String profile;
 							while (command.size() > ic+1 && !command[ic+1].StartsWith("-")) {
 								ic++;
 								String pparam = ToLower(command[ic]);
@@ -767,6 +1004,14 @@ bool BMR_Data::ConsoleMain(const UVector<String>& _command, bool gui) {
 									numCases = ScanInt(command[ic]);	
 									if (IsNull(numCases))
 										throw Exc(F(t_("Wrong argument '%s'"), command[ic]));
+								} else if (pparam == "balance") 
+									balance = true;
+								else if (pparam == "profile") {
+									CheckIfAvailableArg(command, ++ic, "profile");
+									profile = command[ic];
+									if (!FileExists(profile)) 
+										throw Exc(F(t_("File '%s' not found"), profile));
+									balance = true;
 								} else if (pparam == "numthreads") {
 									CheckIfAvailableArg(command, ++ic, "numThreads");
 									numThreads = ScanInt(command[ic]);	
@@ -775,8 +1020,32 @@ bool BMR_Data::ConsoleMain(const UVector<String>& _command, bool gui) {
 								} else
 									throw Exc(F(t_("Wrong command '%s'"), command[ic]));
 /*bem*/						}
+							BMR_Bem_SaveCase_Balance_Set(balance, profile);
 							BMR_Bem_SaveCase(folder, solver, x0z, y0z, irregular, autoIrregular, qtfType, autoQTF, bin, numCases, numThreads, withPotentials, withMesh);
 							BEM::Print("\n" + F(t_("Saved model %d in %s case format"), bemid+1, solver));
+						} else if (param == "-casesets") {
+							if (Bem().hydros.size() < bemid) 
+								throw Exc(F(t_("Model %d is not loaded"), bemid));
+							Hydro &hy = Bem().hydros[bemid];
+							
+							CheckIfAvailableArg(command, ++ic, "-caseSets");
+							int numCases = ScanInt(command[ic]);
+							if (IsNull(numCases) || numCases < 1 || numCases > hy.dt.Nf)
+								throw Exc(F(t_("Wrong argument '%s'"), command[ic]));
+							String profile;
+							if (command.size() > ic+1 && ToLower(command[ic+1]) == "profile") {
+								ic++;
+								CheckIfAvailableArg(command, ++ic, "profile");
+								profile = command[ic];
+								if (!FileExists(profile)) 
+									throw Exc(F(t_("File '%s' not found"), profile));
+							}
+							BMR_Bem_SaveCase_Balance_Set(true, profile);
+							UVector<int> sets = hy.GetCaseSets(numCases, true, 0);
+							lastPrint.Clear();
+							for (int num : sets)
+								lastPrint << num << " ";
+							BEM::Print("\n" + F(t_("Frequencies per case: %s"), lastPrint));
 						} else if (param == "-bodyparams" || param == "-body" ) {
 							CheckIfAvailableArg(command, ic+1, "-bodyparams");
 							if (Bem().hydros.size() < bemid) 
@@ -1291,12 +1560,275 @@ bool BMR_Data::ConsoleMain(const UVector<String>& _command, bool gui) {
 							if (!FileExists(file)) 
 								throw Exc(F(t_("File '%s' not found"), file)); 
 							
+							UVector<String> params;
+							while (command.size() > ic+1 && !command[ic+1].StartsWith("-")) 
+								params << command[++ic];
+							
 							BEM::Print("\n");
-							String ret = fast.Load(file, echo ? Status : NoPrint);
+							String ret = fast.Load(file, echo ? Status : NoPrint, params);
 							if (ret.IsEmpty())
 								BEM::Print("\n" + F(t_("File '%s' loaded"), file));
 							else
 								BEM::PrintWarning("\n" + F(t_("Problem loading '%s': %s"), file, ret));
+						} else if (param == "-benchcases") {
+							CheckIfAvailableArg(command, ++ic, "-benchCases");
+							
+							String file = FileName(command[ic]);
+							if (!FileExists(file)) 
+								throw Exc(F(t_("File '%s' not found"), file)); 
+							
+							int numCases = 1000;
+							if (command.size() > ic+1 && !command[ic+1].StartsWith("-")) {
+								numCases = ScanInt(command[++ic]);
+								if (IsNull(numCases) || numCases < 1)
+									throw Exc(F(t_("Wrong number of cases '%s'"), command[ic]));
+							}
+							int numEqual;
+							BEM::Print("\n" + FASTCase::BenchmarkCases(file, numCases, numEqual));
+							lastPrint = FormatInt(numEqual);
+						} else if (param == "-casematrix") {
+							CheckIfAvailableArg(command, ++ic, "-caseMatrix");
+							String seed = FileName(command[ic]);
+							if (!FileExists(seed) && !DirectoryExists(seed)) 
+								throw Exc(F(t_("File '%s' not found"), seed)); 
+							
+							CheckIfAvailableArg(command, ++ic, "-caseMatrix folder");
+							String folder = FileName(command[ic]);
+							
+							FASTCaseMatrix matrix;
+							while (command.size() > ic+1 && !command[ic+1].StartsWith("-") && command[ic+1].Find(':') >= 0) {
+								String var = command[++ic];
+								CheckIfAvailableArg(command, ++ic, "-caseMatrix values");
+								matrix.AddVar(var, command[ic]);
+							}
+							TimeStop t;
+							String ret = matrix.Create(seed, folder, Null, echo ? Status : NoPrint);
+							if (!ret.IsEmpty())
+								throw Exc(ret);
+							double sec = t.Seconds();
+							int num = matrix.GetCount();
+							BEM::Print("\n" + F(t_("%d cases created in '%s' in %.3f s, %.1f cases/s"), num, folder, sec, num/max(sec, 1E-9)));
+							BEM::Print("\n" + F(t_("Files written: %d, linked: %d, copied: %d"), matrix.numWritten, matrix.numLinked, matrix.numCopied));
+							lastPrint = FormatInt(num);
+						} else if (param == "-stats") {
+							CheckIfAvailableArg(command, ++ic, "-stats folder");
+							String folder = FileName(command[ic]);
+							if (!DirectoryExists(folder)) 
+								throw Exc(F(t_("Folder '%s' not found"), folder)); 
+							CheckIfAvailableArg(command, ++ic, "-stats pattern");
+							String pattern = command[ic];
+							CheckIfAvailableArg(command, ++ic, "-stats csv");
+							String fileCsv = FileName(command[ic]);
+							
+							ParameterMetrics params, realparams;
+							int numThreads = Null;
+							double start = 0, end = Null;
+							while (command.size() > ic+1 && !command[ic+1].StartsWith("-")) {
+								String pparam = command[++ic];
+								if (ToLower(pparam) == "threads") {
+									CheckIfAvailableArg(command, ++ic, "-stats threads");
+									numThreads = ScanInt(command[ic]);
+									if (IsNull(numThreads) || numThreads < 1)
+										throw Exc(F(t_("Wrong number of threads '%s'"), command[ic]));
+								} else if (ToLower(pparam) == "start") {
+									CheckIfAvailableArg(command, ++ic, "-stats start");
+									start = ScanDouble(command[ic]);
+									if (IsNull(start))
+										throw Exc(F(t_("Wrong time '%s'"), command[ic]));
+								} else if (ToLower(pparam) == "end") {
+									CheckIfAvailableArg(command, ++ic, "-stats end");
+									end = ScanDouble(command[ic]);
+									if (IsNull(end))
+										throw Exc(F(t_("Wrong time '%s'"), command[ic]));
+								} else {
+									CheckIfAvailableArg(command, ++ic, "-stats metrics");
+									ParameterMetric &p = params.params.Add();
+									p.name = pparam;
+									p.decimals = 3;
+									String metric;
+									int level = 0;			// Commas inside the parenthesis of percentile(a, b) are not separators
+									for (int c : command[ic]) {
+										if (c == ',' && level == 0) {
+											p.metrics << TrimBoth(metric);
+											metric.Clear();
+										} else {
+											if (c == '(')
+												level++;
+											else if (c == ')')
+												level--;
+											metric.Cat(c);
+										}
+									}
+									if (!TrimBoth(metric).IsEmpty())
+										p.metrics << TrimBoth(metric);
+								}
+							}
+							if (params.params.IsEmpty())
+								throw Exc(t_("-stats requires at least a parameter and its metrics"));
+							
+							UVector<String> files;
+							CaseRunner::ListFiles(folder, pattern, files);
+							if (files.IsEmpty())
+								throw Exc(F(t_("No '%s' file found in '%s'"), pattern, folder));
+							for (String &file : files)
+								file = AFX(folder, file);
+							
+							FileOut out(fileCsv);
+							if (!out)
+								throw Exc(F(t_("Impossible to open file '%s'"), fileCsv));
+							const String &sep = Bem().csvSeparator;
+							int numRows = 0;
+							String firstRow;
+							TimeStop t;
+							String ret = CalcStream(files, params, realparams, start, end, [&](const UVector<Value> &row) {
+								if (numRows++ == 0) {
+									out << "File" << sep << "Begin" << sep << "End";
+									for (const ParameterMetric &param : realparams.params)
+										for (const String &metric : param.metrics)
+											out << sep << param.name << " " << metric;
+								}
+								out << "\n";
+								for (int i = 0; i < row.size(); ++i) {
+									if (i > 0)
+										out << sep;
+									if (i < 3)
+										out << row[i].ToString();
+									else if (!IsNull(row[i]))
+										out << FDS(double(row[i]), 10);
+									if (numRows == 1 && i >= 3)
+										firstRow << " " << (IsNull(row[i]) ? String("-") : FormatDouble(double(row[i])));
+								}
+								out.Flush();
+							}, numThreads, echo ? Status : NoPrint);
+							if (!ret.IsEmpty())
+								throw Exc(ret);
+							
+							BEM::Print("\n" + F(t_("Statistics of %d files saved in '%s' in %.3f s"), files.size(), fileCsv, t.Seconds()));
+							lastPrint = FormatInt(files.size()) + firstRow;
+						} else if (param == "-sidecar") {
+							CheckIfAvailableArg(command, ++ic, "-sidecar");
+							
+							String val = ToLower(command[ic]);
+							fast.sidecar = val == "true" || val == "yes";
+							BEM::Print("\n" + F(t_("Time series sidecar is %s"), fast.sidecar ? t_("enabled") : t_("disabled")));
+						} else if (param == "-benchsidecar") {
+							CheckIfAvailableArg(command, ++ic, "-benchSidecar");
+							
+							String file = FileName(command[ic]);
+							if (!FileExists(file)) 
+								throw Exc(F(t_("File '%s' not found"), file)); 
+							
+							int num;
+							BEM::Print("\n" + FastOut::BenchmarkSidecar(file, num));
+							lastPrint = FormatInt(num);
+						} else if (param == "-benchsave") {
+							if (fast.IsEmpty()) 
+								throw Exc(t_("No file loaded"));
+							
+							CheckIfAvailableArg(command, ++ic, "-benchSave");
+							
+							String folder = FileName(command[ic]);
+							if (!DirectoryExists(folder)) 
+								throw Exc(F(t_("Folder '%s' not found"), folder)); 
+							
+							int num;
+							BEM::Print("\n" + fast.BenchmarkSave(folder, num));
+							lastPrint = FormatInt(num);
+						} else if (param == "-single") {
+							CheckIfAvailableArg(command, ++ic, "-single");
+							
+							String val = ToLower(command[ic]);
+							fast.single = val == "true" || val == "yes";
+							BEM::Print("\n" + F(t_("Time series single precision is %s"), fast.single ? t_("enabled") : t_("disabled")));
+						} else if (param == "-benchsingle") {
+							CheckIfAvailableArg(command, ++ic, "-benchSingle");
+							
+							String file = FileName(command[ic]);
+							if (!FileExists(file)) 
+								throw Exc(F(t_("File '%s' not found"), file)); 
+							
+							int num;
+							BEM::Print("\n" + FastOut::BenchmarkSingle(file, num));
+							lastPrint = FormatInt(num);
+						} else if (param == "-derived") {
+							if (fast.IsEmpty()) 
+								throw Exc(t_("No file loaded"));
+							
+							fast.CalcDerived();
+							int num = fast.GetDerivedCount();
+							BEM::Print("\n" + F(t_("%d derived channels added"), num));
+							lastPrint = FormatInt(num);
+						} else if (param == "-benchderived") {
+							if (fast.IsEmpty()) 
+								throw Exc(t_("No file loaded"));
+							
+							int num;
+							BEM::Print("\n" + fast.BenchmarkDerived(num));
+							lastPrint = FormatInt(num);
+						} else if (param == "-benchrainflow") {
+							int num = 10000000;
+							if (command.size() > ic+1 && !command[ic+1].StartsWith("-")) {
+								num = ScanInt(command[++ic]);
+								if (IsNull(num) || num < 1)
+									throw Exc(F(t_("Wrong number of samples '%s'"), command[ic]));
+							}
+							double cycles;
+							BEM::Print("\n" + BenchmarkRainflow(num, cycles));
+							lastPrint = FormatDouble(cycles);
+						} else if (param == "-benchplot") {
+							if (fast.IsEmpty()) 
+								throw Exc(t_("No file loaded"));
+							
+							CheckIfAvailableArg(command, ++ic, "-benchPlot");
+							int col = fast.GetParameter_throw(command[ic]);
+							int pixels = 1000;
+							if (command.size() > ic+1 && !command[ic+1].StartsWith("-")) {
+								pixels = ScanInt(command[++ic]);
+								if (IsNull(pixels) || pixels < 1)
+									throw Exc(F(t_("Wrong number of pixels '%s'"), command[ic]));
+							}
+							double tfrom = Null, tto = Null;
+							if (command.size() > ic+1 && !command[ic+1].StartsWith("-")) {
+								tfrom = ScanDouble(command[++ic]);
+								CheckIfAvailableArg(command, ++ic, "-benchPlot to");
+								tto = ScanDouble(command[ic]);
+								if (IsNull(tfrom) || IsNull(tto) || tfrom >= tto)
+									throw Exc(F(t_("Wrong time window '%s'"), command[ic]));
+							}
+							int num = fast.GetNumData();
+							const UVector<double> &time = fast.GetUVector(0), &data = fast.GetUVector(col);
+							
+							TimeStop t;
+							MinMaxPyramid pyr;
+							pyr.Build(data);
+							BEM::Print("\n" + F(t_("Pyramid of %d samples built in %.3f ms"), num, t.Seconds()*1000));
+							
+							FastOutSource src;
+							src.Init(fast, col, 0, num, 1);
+							for (int div = 1; div <= 10000 && num/div > 1; div *= 10) {
+								int nq = 100;
+								t.Reset();
+								for (int iq = 0; iq < nq; ++iq) {		// Panning windows of 1/div of the series
+									int id0 = int((int64(num - num/div)*iq)/nq);
+									src.SetView(time[id0], time[id0 + num/div - 1], pixels);
+								}
+								BEM::Print("\n" + F(t_("Window of %8d samples: %6d points, %.4f ms per query"), num/div, (int)src.GetCount(), t.Seconds()*1000/nq));
+							}
+							auto GetMax = [&](double from, double to) {
+								src.SetView(from, to, pixels);
+								double mx = Null;
+								for (int i = 0; i < src.GetCount(); ++i)
+									if (!IsNull(src.y(i)))
+										mx = IsNull(mx) ? src.y(i) : max(mx, src.y(i));
+								return mx;
+							};
+							lastPrint = FormatDouble(GetMax(Null, Null));
+							BEM::Print("\n" + F(t_("Plotted max: %s"), lastPrint));
+							if (!IsNull(tfrom)) {
+								String mxWindow = FormatDouble(GetMax(tfrom, tto));
+								BEM::Print("\n" + F(t_("Plotted max from %s to %s s: %s"), FormatDouble(tfrom), FormatDouble(tto), mxWindow));
+								lastPrint << " " << mxWindow;
+							}
 /*time*/				} else if (param == "-c" || param == "-convert" || param == "-save") {
 							if (fast.IsEmpty()) 
 								throw Exc(t_("No file loaded"));
@@ -1348,7 +1880,14 @@ bool BMR_Data::ConsoleMain(const UVector<String>& _command, bool gui) {
 											lastPrint = FormatDouble(d.maxCoeff());
 										else if (command[ic] == "min") 
 											lastPrint = FormatDouble(d.minCoeff());
-										else  
+										else if (command[ic] == "del") {
+											CheckIfAvailableArg(command, ++ic, "<m>");
+											double m = ScanDouble(command[ic]);
+											double neq = fast.GetTimeEnd() - fast.GetTimeStart();
+											if (command.size() > ic+1 && !IsNull(ScanDouble(command[ic+1]))) 
+												neq = ScanDouble(command[++ic]);
+											lastPrint = FormatDouble(GetDEL(d, m, neq));
+										} else  
 											throw Exc(F(t_("Parameter '%s' not found"), command[ic]));
 									}
 									Cout() << lastPrint;
@@ -1361,7 +1900,8 @@ bool BMR_Data::ConsoleMain(const UVector<String>& _command, bool gui) {
 						} else
 							throw Exc(F(t_("Unknown argument '%s'"), command[ic]));
 /*wind*/			} else if (nextcommands == "wind") {
-						if (param == "-i" || param == "-input") {
+						if (param == "-i" || param == "-input" || param == "-is" || param == "-istream") {
+							bool stream = param == "-is" || param == "-istream";
 							CheckIfAvailableArg(command, ++ic, "--input");
 							
 							String file = FileName(command[ic]);
@@ -1370,7 +1910,7 @@ bool BMR_Data::ConsoleMain(const UVector<String>& _command, bool gui) {
 							
 							Wind &w = wind.Add();
 							String ret;
-							if (!IsEmpty(ret = w.Load(file)))
+							if (!IsEmpty(ret = w.Load(file, "", stream)))
 								throw Exc(ret);
 							
 							windid = wind.size() - 1;
@@ -1378,6 +1918,9 @@ bool BMR_Data::ConsoleMain(const UVector<String>& _command, bool gui) {
 						} else if (param == "-params") {
 							CheckIfAvailableArg(command, ic+1, "-params");
 							
+							if (!wind.IsEmpty())
+								wind[windid].BeginTransform();		// All the velocity changes are applied together
+							
 							while (command.size() > ic+1 && !command[ic+1].StartsWith("-")) {
 								++ic;
 								if (ToLower(command[ic]) == "hubheight") {
@@ -1475,6 +2018,11 @@ bool BMR_Data::ConsoleMain(const UVector<String>& _command, bool gui) {
 								} else 
 									throw Exc(F(t_("Wrong command '%s'"), command[ic]));
 							}
+							if (!wind.IsEmpty()) {
+								TimeStop t;
+								if (wind[windid].ApplyTransform())
+									BEM::Print("\n" + F(t_("Velocity changes applied in %.3f s"), t.Seconds()));
+							}
 						} else if (param == "-r" || param == "-report") {
 							if (wind.IsEmpty()) 
 								throw Exc(t_("Report: No file loaded"));
@@ -1509,10 +2057,142 @@ bool BMR_Data::ConsoleMain(const UVector<String>& _command, bool gui) {
 							
 							String file = FileName(command[ic]);
 							
+							TimeStop t;
 							String ret;
 							if (!IsEmpty(ret = wind[windid].Save(file)))
 								throw Exc(ret);
+							double secs = t.Seconds();
 							BEM::Print("\n" + F(t_("Model id %d saved as '%s'"), windid, file));
+							int64 sz = GetFileLength(file);
+							if (sz > 0)
+								BEM::Print(" " + F(t_("(%s in %.3f s, %.1f MB/s)"), FormatFileSize(sz), secs, sz/1048576./max(secs, 1e-6)));
+						} else if (param == "-spectra") {
+							if (wind.IsEmpty()) 
+								throw Exc(t_("No file loaded"));
+							
+							CheckIfAvailableArg(command, ++ic, "-spectra");
+							String file = FileName(command[ic]);
+							int comp = 0, nfft = Null;
+							if (command.size() > ic+1 && !command[ic+1].StartsWith("-")) {
+								comp = ScanInt(command[++ic]);
+								if (IsNull(comp))
+									throw Exc(F(t_("Wrong component '%s'"), command[ic]));
+								if (command.size() > ic+1 && !command[ic+1].StartsWith("-")) {
+									nfft = ScanInt(command[++ic]);
+									if (IsNull(nfft))
+										throw Exc(F(t_("Wrong FFT length '%s'"), command[ic]));
+								}
+							}
+							TimeStop t;
+							String ret;
+							if (!IsEmpty(ret = wind[windid].SaveSpectra(file, comp, nfft)))
+								throw Exc(ret);
+							BEM::Print("\n" + F(t_("Spectra of model id %d saved as '%s' in %.3f s"), windid, file, t.Seconds()));
+						} else if (param == "-benchspectra") {
+							CheckIfAvailableArg(command, ++ic, "-benchSpectra u");
+							double u = ScanDouble(command[ic]);
+							CheckIfAvailableArg(command, ++ic, "-benchSpectra TI");
+							double ti = ScanDouble(command[ic]);
+							CheckIfAvailableArg(command, ++ic, "-benchSpectra L");
+							double l = ScanDouble(command[ic]);
+							double tiCalc, lCalc;
+							BEM::Print("\n" + Wind::BenchmarkSpectra(u, ti, l, tiCalc, lCalc));
+							lastPrint = F("%.2f %.1f", tiCalc, lCalc);
+						} else if (param == "-compare") {
+							if (wind.IsEmpty()) 
+								throw Exc(t_("No file loaded"));
+							
+							CheckIfAvailableArg(command, ++ic, "-compare id");
+							int id = ScanInt(command[ic]);
+							if (IsNull(id) || id < 0 || id > wind.size()-1)
+								throw Exc(F(t_("Invalid id %s"), command[ic]));
+							CheckIfAvailableArg(command, ++ic, "-compare tolerance");
+							double tol = ScanDouble(command[ic]);
+							if (IsNull(tol) || tol < 0)
+								throw Exc(F(t_("Wrong tolerance '%s'"), command[ic]));
+							
+							double diff = wind[windid].GetMaxDifference(wind[id]);
+							BEM::Print("\n" + F(t_("Highest difference between model id %d and %d is %g m/s"), windid, id, diff));
+							if (diff > tol)
+								throw Exc(F(t_("Difference %g m/s is higher than %g m/s"), diff, tol));
+							lastPrint = FormatDouble(diff);
+						} else if (param == "-benchtransform") {
+							if (wind.IsEmpty()) 
+								throw Exc(t_("No file loaded"));
+							
+							double vals[3];
+							for (int i = 0; i < 3; ++i) {
+								CheckIfAvailableArg(command, ++ic, "-benchTransform");
+								vals[i] = ScanDouble(command[ic]);
+								if (IsNull(vals[i]))
+									throw Exc(F(t_("Wrong argument '%s'"), command[ic]));
+							}
+							int num;
+							BEM::Print("\n" + wind[windid].BenchmarkTransform(float(vals[0]), float(vals[1]), float(vals[2]), num));
+							lastPrint = FormatInt(num);
+						} else if (param == "-interpolate") {
+							if (wind.IsEmpty()) 
+								throw Exc(t_("No file loaded"));
+							
+							CheckIfAvailableArg(command, ++ic, "Query file");
+							String qfile = FileName(command[ic]);
+							CheckIfAvailableArg(command, ++ic, "Output file");
+							String ofile = FileName(command[ic]);
+							
+							if (!FileExists(qfile)) 
+								throw Exc(F(t_("File '%s' not found"), qfile)); 
+							
+							// Each row is "y z" for the velocity norm at a point, or "y z radius yaw" for the rotor equivalent velocity
+							UVector<UVector<double>> rows;
+							bool rews = false;
+							for (String line : Split(LoadFile(qfile), '\n')) {
+								UVector<String> fields = Split(TrimBoth(line), [](int c) {return IsSpace(c) || c == ',' || c == ';' ? 1 : 0;});
+								if (fields.IsEmpty() || fields[0].StartsWith("#"))
+									continue;
+								UVector<double> &row = rows.Add();
+								for (const String &f : fields) {
+									double d = ScanDouble(f);
+									if (IsNull(d))
+										throw Exc(F(t_("Wrong value '%s' in '%s'"), f, qfile));
+									row << d;
+								}
+								if (rows.size() == 1)
+									rews = row.size() >= 4;
+								if (row.size() < (rews ? 4 : 2))
+									throw Exc(F(t_("Wrong number of values in row %d of '%s'"), rows.size(), qfile));
+							}
+							if (rows.IsEmpty())
+								throw Exc(F(t_("No queries found in '%s'"), qfile));
+							
+							int np = rows.size();
+							VectorXd y(np), z(np), radius(np), yaw(np), time;
+							for (int i = 0; i < np; ++i) {
+								y(i) = rows[i][0];
+								z(i) = rows[i][1];
+								if (rews) {
+									radius(i) = rows[i][2];
+									yaw(i) = rows[i][3];
+								}
+							}
+							
+							Wind &w = wind[windid];
+							TimeStop t;
+							MatrixXd v = rews ? w.GetRotorEquivalent(y, z, radius, yaw, time) : w.Interpolate(-1, y, z, time);
+							double secs = t.Seconds();
+							
+							const String &sep = Bem().csvSeparator;
+							String str = "time";
+							for (int i = 0; i < np; ++i)
+								str << sep << (rews ? "rews" : "vel") << i+1;
+							for (int it = 0; it < v.cols(); ++it) {
+								str << "\n" << FDS(it*w.GetDt(), 10);
+								for (int i = 0; i < np; ++i)
+									str << sep << FDS(v(i, it), 10);
+							}
+							if (!SaveFile(ofile, str))
+								throw Exc(F(t_("Impossible to save '%s'"), ofile));
+							BEM::Print("\n" + F(t_("%d series of %d time steps saved in '%s'. Computed in %.3f s (%.0f series/s)"), 
+												np, (int)v.cols(), ofile, secs, np/max(secs, 1e-6)));
 						} else if (param == "-p" || param == "-print") {
 							Wind &w = wind[windid];
 							while (command.size() > ic+1 && !command[ic+1].StartsWith("-")) {
@@ -1578,6 +2258,45 @@ bool BMR_Data::ConsoleMain(const UVector<String>& _command, bool gui) {
 										lastPrint << v(id);
 									}
 									BEM::Print(lastPrint);
+								} else if (pparam == "velinterp" || pparam == "rews") {
+									bool rews = pparam == "rews";
+									BEM::Print("\n");
+									BEM::Print((rews ? t_("Rotor equivalent velocity:") : t_("Interpolated velocity:")) + F(" "));
+									lastPrint.Clear();
+									
+									CheckIfAvailableArg(command, ++ic, "Position Y");
+									VectorXd ypos = VectorXd::Constant(1, ScanDouble(command[ic]));
+									CheckIfAvailableArg(command, ++ic, "Position Z");
+									VectorXd zpos = VectorXd::Constant(1, ScanDouble(command[ic]));
+									VectorXd radius, yaw;
+									if (rews) {
+										CheckIfAvailableArg(command, ++ic, "Radius");
+										radius = VectorXd::Constant(1, ScanDouble(command[ic]));
+										CheckIfAvailableArg(command, ++ic, "Yaw");
+										yaw = VectorXd::Constant(1, ScanDouble(command[ic]));
+										if (IsNull(radius(0)) || IsNull(yaw(0)))
+											throw Exc(t_("Wrong radius or yaw in rews"));
+									}
+									if (IsNull(ypos(0)) || IsNull(zpos(0)))
+										throw Exc(F(t_("Wrong position in %s"), pparam));
+									
+									CheckIfAvailableArg(command, ++ic, "<time>/avg/data");
+									String what = command[ic];
+									VectorXd time;
+									if (what != "avg" && what != "data") {
+										time = VectorXd::Constant(1, ScanDouble(what));
+										if (IsNull(time(0)))
+											throw Exc(F(t_("Parameter time not found in %s"), pparam));
+									}
+									MatrixXd v = rews ? w.GetRotorEquivalent(ypos, zpos, radius, yaw, time) : w.Interpolate(-1, ypos, zpos, time);
+									if (what == "avg")
+										lastPrint << v.row(0).mean();
+									else {
+										for (int i = 0; i < v.cols(); ++i) 
+											lastPrint << v(0, i) << " ";
+										lastPrint = TrimRight(lastPrint);
+									}
+									BEM::Print(lastPrint);
 								} else if (pparam == "time") {
 									BEM::Print("\n");
 									BEM::Print(t_("Time:") + F(" "));
@@ -1596,6 +2315,119 @@ bool BMR_Data::ConsoleMain(const UVector<String>& _command, bool gui) {
 							ic--;							
 						} else 
 							throw Exc(F(t_("Unknown argument '%s'"), command[ic]));
+/*mooring*/			} else if (nextcommands == "mooring") {
+						auto GetVessel = [&]()->int {
+							if (command.size() > ic+1 && !command[ic+1].StartsWith("-")) {
+								String name = command[++ic];
+								int iv = mooring.FindVessel(name);
+								if (iv < 0)
+									throw Exc(F(t_("Vessel '%s' not found"), name));
+								return iv;
+							}
+							return 0;
+						};
+						if (param == "-i" || param == "-input") {
+							CheckIfAvailableArg(command, ++ic, "--input");
+							
+							String file = FileName(command[ic]);
+							if (!FileExists(file)) 
+								throw Exc(F(t_("File '%s' not found"), file)); 
+							
+							if (!mooring.Load(file))
+								throw Exc(F(t_("Problem loading '%s'"), file));
+							if (mooring.vessels.IsEmpty())
+								throw Exc(F(t_("No vessel found in '%s'"), file));
+							if (!mooring.Calc(Bem().rho))
+								throw Exc(F(t_("Problem calculating '%s'"), file));
+							BEM::Print("\n" + F(t_("File '%s' loaded"), file));
+						} else if (param == "-stiffness") {
+							if (mooring.lineProperties.IsEmpty()) 
+								throw Exc(t_("No file loaded"));
+							int iv = GetVessel();
+							
+							TimeStop t;
+							MatrixXd K = mooring.GetStiffness(iv, Bem().rho);
+							double secs = t.Seconds();
+							
+							BEM::Print("\n" + F(t_("Mooring stiffness of vessel '%s' [N/m, N/rad, N·m/m, N·m/rad]:"), mooring.vessels[iv].name));
+							lastPrint.Clear();
+							for (int i = 0; i < 6; ++i) {
+								String str;
+								for (int j = 0; j < 6; ++j) {
+									str << F(" %12.5g", K(i, j));
+									lastPrint << K(i, j) << " ";
+								}
+								BEM::Print("\n" + str);
+							}
+							lastPrint = TrimRight(lastPrint);
+							BEM::Print("\n" + F(t_("Computed in %.3f s"), secs));
+						} else if (param == "-benchloads") {
+							if (mooring.lineProperties.IsEmpty()) 
+								throw Exc(t_("No file loaded"));
+							
+							CheckIfAvailableArg(command, ++ic, "-benchLoads");
+							int num = ScanInt(command[ic]);
+							if (IsNull(num) || num < 1)
+								throw Exc(F(t_("Wrong number of offsets '%s'"), command[ic]));
+							int iv = GetVessel();
+							
+							BEM::Print("\n" + mooring.BenchmarkLoads(iv, Bem().rho, num));
+							lastPrint = FormatInt(num);
+						} else if (param == "-sweep") {
+							if (mooring.lineProperties.IsEmpty()) 
+								throw Exc(t_("No file loaded"));
+							
+							CheckIfAvailableArg(command, ++ic, "DOF");
+							int idof = ScanInt(command[ic]);
+							if (IsNull(idof) || idof < 1 || idof > 6)
+								throw Exc(F(t_("Wrong DOF '%s'. It has to be 1 to 6"), command[ic]));
+							idof--;
+							CheckIfAvailableArg(command, ++ic, "From");
+							double from = ScanDouble(command[ic]);
+							CheckIfAvailableArg(command, ++ic, "To");
+							double to = ScanDouble(command[ic]);
+							CheckIfAvailableArg(command, ++ic, "Number");
+							int num = ScanInt(command[ic]);
+							if (IsNull(from) || IsNull(to) || IsNull(num) || num < 2)
+								throw Exc(t_("Wrong sweep range"));
+							CheckIfAvailableArg(command, ++ic, "File");
+							String file = FileName(command[ic]);
+							int iv = GetVessel();
+							
+							double factor = idof < 3 ? 1 : M_PI/180;	// Rotations in degrees
+							MatrixXd pos = MatrixXd::Zero(num, 6);
+							for (int i = 0; i < num; ++i)
+								pos(i, idof) = (from + (to - from)*i/(num - 1))*factor;
+							
+							TimeStop t;
+							MatrixXd f = mooring.GetVesselLoads(iv, pos, Bem().rho);
+							double secs = t.Seconds();
+							
+							const String &sep = Bem().csvSeparator;
+							String str = F("offset %s", idof < 3 ? "[m]" : "[deg]");
+							for (const char *name : {"Fx [N]", "Fy [N]", "Fz [N]", "Mx [N·m]", "My [N·m]", "Mz [N·m]"})
+								str << sep << name;
+							for (int i = 0; i < num; ++i) {
+								str << "\n" << FDS(pos(i, idof)/factor, 10);
+								for (int j = 0; j < 6; ++j)
+									str << sep << (IsNull(f(i, j)) ? String() : FDS(f(i, j), 10));
+							}
+							if (!SaveFile(file, str))
+								throw Exc(F(t_("Impossible to save '%s'"), file));
+							BEM::Print("\n" + F(t_("%d offsets of vessel '%s' saved in '%s'. Computed in %.3f s"), num, mooring.vessels[iv].name, file, secs));
+						} else if (param == "-benchmooring") {
+							CheckIfAvailableArg(command, ++ic, "-benchMooring");
+							
+							int lines = ScanInt(command[ic]);
+							if (IsNull(lines) || lines < 6)
+								throw Exc(F(t_("Wrong number of lines '%s'"), command[ic]));
+							BEM::Print("\n" + Mooring::BenchmarkClosest(lines));
+						} else if (mainCommands.Find(param) >= 0) {
+							commandBeforeGeneral = nextcommands;
+							nextcommands = "general";
+							ic--;							
+						} else 
+							throw Exc(F(t_("Unknown argument '%s'"), command[ic]));
 					}
 #ifdef PLATFORM_WIN32						
 					else if (nextcommands == "orca") {
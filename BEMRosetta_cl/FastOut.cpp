@@ -8,6 +8,7 @@
 #include <Functions4U/Functions4U.h>
 #include <Functions4U/EvalExpr.h>
 #include <ScatterDraw/Equation.h>
+#include <atomic>
 
 using namespace Upp;
 
@@ -139,7 +140,7 @@ String FastOut::GetFileToLoad(String fileName) {
 	return "";
 }
 
-String FastOut::Load(String file, Function <bool(String, int)> Status) {
+String FastOut::Load(String file, Function <bool(String, int)> Status, const UVector<String> &params) {
 	String ext = ToLower(GetFileExt(file));
 	
 	if (ext == ".out")
@@ -166,6 +167,15 @@ String FastOut::Load(String file, Function <bool(String, int)> Status) {
 	}
 	file = ForceExtSafer(file, ext);
 	
+	if (sidecar && LoadSidecar(file, params)) {
+		fileName = file;
+		AfterLoad();
+		pyramids.Clear();		// Built when plotted, in GetPyramid()
+		if (single)
+			PackSingle();
+		return String();
+	}
+	
 	String ret;
 	if (ext == ".out")
 		ret = LoadOut(file, Status);
@@ -189,9 +199,204 @@ String FastOut::Load(String file, Function <bool(String, int)> Status) {
 		AppendLine(numline, line);
 	}
 	
-	if (ret.IsEmpty())
+	if (ret.IsEmpty()) {
+		if (sidecar)
+			SaveSidecar(file);
+		if (!params.IsEmpty())
+			SelectParameters(params);
 		AfterLoad();
+		pyramids.Clear();		// Built when plotted, in GetPyramid()
+		if (single)
+			PackSingle();
+	}
+	return ret;
+}
+
+// The sidecar is a header followed by one block per channel with its GetNumData() values, 
+// so that a channel is read without reading the others
+struct FastOutSidecar {
+	static const int version = 1;
+	
+	String magic = "BEMRosetta time series";
+	int ver = version;
+	String key;
+	double Hs = Null, Tp = Null, heading = Null;
+	int numData = 0;
+	UVector<String> parameters, units, descriptions;
+	
+	void Serialize(Stream &s) {
+		s % magic % ver % key % Hs % Tp % heading % numData % parameters % units % descriptions;
+	}
+};
+
+// Size and date of the file and of its MoorDyn line files. If any changes, the sidecar is parsed again
+String FastOut::GetSidecarKey(String file) {
+	UVector<String> files;
+	files << file;
+	String prefix = GetFileTitle(file) + ".MD.Line";
+	for (FindFile ff(AFX(GetFileFolder(file), prefix + "*.out")); ff; ff++) 
+		files << ff.GetPath();
+	Sort(files);
+	
+	String ret;
+	for (const String &f : files) {
+		FindFile ff(f);
+		if (ff)
+			ret << F("%s;%d;%s\n", ff.GetName(), ff.GetLength(), Format(Time(ff.GetLastWriteTime())));
+	}
+	return ret;
+}
+
+static UVector<int> MatchParameters(const UVector<String> &parameters, const UVector<String> &params) {
+	UVector<int> ids;
+	ids << 0;								// Time is always included
+	for (int i = 1; i < parameters.size(); ++i) {
+		String name = ToLower(parameters[i]);
+		for (const String &param : params) {
+			if (PatternMatch(ToLower(param), name)) {
+				ids << i;
+				break;
+			}
+		}
+	}
+	return ids;
+}
+
+void FastOut::SelectParameters(const UVector<String> &params) {
+	UVector<int> ids = MatchParameters(parameters, params);
+	
+	bool withDescriptions = descriptions.size() == parameters.size();
+	parameters = ApplyIndex(parameters, ids);
+	units = ApplyIndex(units, ids);
+	if (withDescriptions)
+		descriptions = ApplyIndex(descriptions, ids);
+	UVector<UVector<double>> data;
+	for (int id : ids)
+		data << pick(dataOut[id]);
+	dataOut = pick(data);
+}
+
+bool FastOut::LoadSidecar(String file, const UVector<String> &params) {
+	FileIn in(GetSidecarName(file));
+	if (!in)
+		return false;
+	
+	FastOutSidecar h;
+	try {
+		in.LoadThrowing();
+		in % h;
+	} catch (const LoadingError &) {
+		return false;
+	}
+	if (h.magic != FastOutSidecar().magic || h.ver != FastOutSidecar::version || h.key != GetSidecarKey(file) ||
+		h.units.size() != h.parameters.size())
+		return false;			// Stale sidecars are overwritten after parsing the file
+	
+	UVector<int> ids;
+	if (params.IsEmpty()) {
+		for (int i = 0; i < h.parameters.size(); ++i)
+			ids << i;
+	} else
+		ids = MatchParameters(h.parameters, params);
 	
+	Clear();
+	int64 pos0 = in.GetPos();
+	int64 sz = int64(h.numData)*sizeof(double);
+	dataOut.SetCount(ids.size());
+	for (int i = 0; i < ids.size(); ++i) {
+		dataOut[i].SetCount(h.numData);
+		in.Seek(pos0 + ids[i]*sz);
+		if (!in.GetAll(dataOut[i].begin(), int(sz))) {
+			Clear();
+			return false;
+		}
+	}
+	parameters = ApplyIndex(h.parameters, ids);
+	units = ApplyIndex(h.units, ids);
+	if (h.descriptions.size() == h.parameters.size())
+		descriptions = ApplyIndex(h.descriptions, ids);
+	Hs = h.Hs;
+	Tp = h.Tp;
+	heading = h.heading;
+	return true;
+}
+
+void FastOut::SaveSidecar(String file) const {
+	FastOutSidecar h;
+	h.key = GetSidecarKey(file);
+	h.Hs = Hs;
+	h.Tp = Tp;
+	h.heading = heading;
+	h.numData = GetNumData();
+	h.parameters = clone(parameters);
+	h.units = clone(units);
+	h.descriptions = clone(descriptions);
+	
+	for (const UVector<double> &data : dataOut)
+		if (data.size() != h.numData)
+			return;
+	
+	// Saved with a temporary name so that an interrupted write is never read as valid. 
+	// If the folder is read only, the file is just parsed every time
+	String fileName = GetSidecarName(file);
+	String fileTemp = fileName + ".tmp";
+	{
+		FileOut out(fileTemp);
+		if (!out)
+			return;
+		out % h;
+		for (const UVector<double> &data : dataOut)
+			out.Put(data.begin(), int(data.size()*sizeof(double)));
+		out.Close();
+		if (out.IsError()) {
+			DeleteFile(fileTemp);
+			return;
+		}
+	}
+	DeleteFile(fileName);
+	if (!FileMove(fileTemp, fileName))
+		DeleteFile(fileTemp);
+}
+
+String FastOut::BenchmarkSidecar(String file, int &num) {
+	String fileSidecar = GetSidecarName(file);
+	DeleteFile(fileSidecar);
+	
+	auto TimeLoad = [&](FastOut &fast, bool sidecar, const UVector<String> &params = UVector<String>()) {
+		fast.sidecar = sidecar;
+		fast.derived = false;
+		TimeStop t;
+		String error = fast.Load(file, Null, params);
+		if (!error.IsEmpty())
+			throw Exc(error);
+		return t.Seconds();
+	};
+	
+	FastOut parsed, saved, loaded, selected;
+	double tParse = TimeLoad(parsed, false);
+	double tSave = TimeLoad(saved, true);
+	if (!FileExists(fileSidecar))
+		throw Exc(F(t_("Impossible to save '%s'"), fileSidecar));
+	double tLoad = TimeLoad(loaded, true);
+	
+	num = parsed.GetParameterCount();
+	String param = parsed.GetParameter(num-1);
+	double tSelected = TimeLoad(selected, true, {param});
+	DeleteFile(fileSidecar);
+	
+	if (!IsEqualRange(loaded.parameters, parsed.parameters) || !IsEqualRange(loaded.units, parsed.units))
+		throw Exc(t_("Channels loaded from sidecar are different"));
+	for (int i = 0; i < num; ++i) 
+		if (!IsEqualRange(loaded.dataOut[i], parsed.dataOut[i]))
+			throw Exc(F(t_("Channel '%s' loaded from sidecar is different"), parsed.GetParameter(i)));
+	if (selected.GetParameterCount() != 2 || !IsEqualRange(selected.dataOut[1], parsed.dataOut[num-1]))
+		throw Exc(F(t_("Channel '%s' loaded alone from sidecar is different"), param));
+	
+	String ret = F(t_("%d channels of %d samples"), num, parsed.GetNumData());
+	ret << "\n" << F(t_("Parsed:                     %8.3f ms"), tParse*1000);
+	ret << "\n" << F(t_("Parsed and sidecar saved:   %8.3f ms"), tSave*1000);
+	ret << "\n" << F(t_("Loaded from sidecar:        %8.3f ms (x%.1f)"), tLoad*1000, tParse/max(tLoad, 1E-9));
+	ret << "\n" << F(t_("One channel from sidecar:   %8.3f ms (x%.1f)"), tSelected*1000, tParse/max(tSelected, 1E-9));
 	return ret;
 }
 
@@ -254,11 +459,58 @@ bool FastOut::Save(String fileSave, Function <bool(String, int)> Status, String
 		type = GetFileExt(fileSave);
 	if (type == ".out")
 		return SaveOut(fileSave, Status, ids);
+	else if (type == ".outb")
+		return SaveOutb(fileSave, Status, ids);
 	else if (type == ".csv")
 		return SaveCsv(fileSave, Status, sep, ids);
 
 	return false;
 }
+
+// Columns to save. Time is always included
+void FastOut::GetSaveIds(const UVector<int> &ids, UVector<int> &cols) const {
+	cols.Clear();
+	Index<int> sel(clone(ids));
+	for (int idparam = 0; idparam < min(dataOut.size(), parameters.size()); ++idparam) 
+		if (idparam == 0 || sel.IsEmpty() || sel.Find(idparam) >= 0)
+			cols << idparam;
+}
+
+// Formats blocks of rows in parallel and writes them in order. The text is the same as the previous row by row writer
+void FastOut::SaveRows(Stream &data, const UVector<int> &cols, String sep, int numDigits, String fileSave, Function <bool(String, int)> Status) const {
+	int num = GetNumData();
+	int nrBlock = max(1, (1 << 20)/(16*max(1, cols.size())));		// ~1 MB of text per block
+	int nBlocks = 4*CPU_Cores();
+	UVector<String> text(nBlocks);
+	
+	for (int idt0 = 0; idt0 < num; idt0 += nrBlock*nBlocks) {
+		if (Status && !Status(F(t_("Saving '%s'"), ::GetFileName(fileSave)), int((100.*idt0)/num)))
+			throw Exc(t_("Stop by user"));
+		
+		int nb = min(nBlocks, (num - idt0 + nrBlock - 1)/nrBlock);
+		CoPartition(0, nb, [&](int ib0, int ib1) {
+			for (int ib = ib0; ib < ib1; ++ib) {
+				int idt1 = idt0 + ib*nrBlock;
+				int idt2 = min(num, idt1 + nrBlock);
+				String &str = text[ib];
+				str.Clear();
+				str.Reserve(16*cols.size()*(idt2 - idt1));
+				for (int idtime = idt1; idtime < idt2; ++idtime) {
+					if (idtime > 0)
+						str << "\n";
+					for (int i = 0; i < cols.size(); ++i) {
+						if (i > 0)
+							str << sep;
+						if (GetNumData(cols[i]) > idtime)
+							str << FDS(GetVal(idtime, cols[i]), numDigits, false);
+					}
+				}
+			}
+		});
+		for (int ib = 0; ib < nb; ++ib)
+			data << text[ib];
+	}
+}
 	
 bool FastOut::SaveOut(String fileSave, Function <bool(String, int)> Status, const UVector<int> &ids) {
 	Status(F(t_("Saving '%s'"), ::GetFileName(fileSave)), 0);
@@ -267,41 +519,275 @@ bool FastOut::SaveOut(String fileSave, Function <bool(String, int)> Status, cons
 	if (!data)
 		return false;
 	
+	UVector<int> cols;
+	GetSaveIds(ids, cols);
+	
 	data << "\n\n\n\n\n\n";
-	for (int idparam = 0; idparam < parameters.size(); ++idparam) {
-		if (idparam == 0 || ids.IsEmpty() || Find(ids, idparam) >= 0) {
-			if (idparam > 0)
-				data << "\t";
-			data << parameters[idparam];
-		}
+	for (int i = 0; i < cols.size(); ++i) {
+		if (i > 0)
+			data << "\t";
+		data << parameters[cols[i]];
 	}
 	data << "\n";
-	for (int idparam = 0; idparam < units.size(); ++idparam) {
-		if (idparam == 0 || ids.IsEmpty() || Find(ids, idparam) >= 0) {
-			if (idparam > 0)
-				data << "\t";
-			data << "(" << units[idparam] << ")";
-		}
+	for (int i = 0; i < cols.size(); ++i) {
+		if (i > 0)
+			data << "\t";
+		data << "(" << units[cols[i]] << ")";
 	}
 	data << "\n";
-	int num = GetNumData();
-	for (int idtime = 0; idtime < num; ++idtime) {
-		if (Status && !(idtime%1000) && !Status(F("Saving '%s'", ::GetFileName(fileSave)), (100*idtime)/num))
+	SaveRows(data, cols, "\t", 10, fileSave, Status);
+	return true;
+}
+
+// Fills blocks of records in parallel and writes each block at once
+template <class T, class Fun>
+static void SaveOutbBody(FileOutBinary &file, const FastOut &fast, const UVector<int> &cols, int NumRecs, 
+						Fun Value, String fileSave, Function <bool(String, int)> Status) {
+	int NumChans = cols.size() - 1;
+	int nrBlock = minmax(int((8 << 20)/(sizeof(T)*max(1, NumChans))), 1, max(1, NumRecs));	// ~8 MB per write
+	Buffer<T> buffer(size_t(nrBlock)*NumChans);
+	for (int idt0 = 0; idt0 < NumRecs; idt0 += nrBlock) {
+		if (Status && !Status(F(t_("Saving '%s'"), ::GetFileName(fileSave)), int((100.*idt0)/NumRecs)))
 			throw Exc(t_("Stop by user"));
-		if (idtime > 0)
-			data << "\n";
-		for (int idparam = 0; idparam < dataOut.size(); ++idparam) {
-			if (idparam == 0 || ids.IsEmpty() || Find(ids, idparam) >= 0) {
-				if (idparam > 0)
-					data << "\t";
-				if (dataOut[idparam].size() > idtime)
-					data << FDS(dataOut[idparam][idtime], 10, false);
+		
+		int nb = min(nrBlock, NumRecs - idt0);
+		CoPartition(0, NumChans, [&](int ic0, int ic1) {
+			for (int ic = ic0; ic < ic1; ++ic) {
+				int col = cols[ic+1];
+				int numData = fast.GetNumData(col);
+				for (int idt = 0; idt < nb; ++idt) 
+					buffer[size_t(idt)*NumChans + ic] = Value(ic, idt0 + idt < numData ? fast.GetVal(idt0 + idt, col) : double(Null));
 			}
+		});
+		file.Write(buffer.begin(), sizeof(T)*size_t(nb)*NumChans);
+	}
+}
+
+// With constant time step the channels are saved without compression. If not, they are compressed to int16 as in OpenFAST.
+// Names and units longer than 10 chars are kept with the ChanLen_In format, that requires constant time step and compression.
+// With variable time step they are cut to 10 chars
+bool FastOut::SaveOutb(String fileSave, Function <bool(String, int)> Status, const UVector<int> &ids) {
+	enum FILETYPE {WithTime = 1, WithoutTime, NoCompressWithoutTime, ChanLen_In};
+	
+	Status(F(t_("Saving '%s'"), ::GetFileName(fileSave)), 0);
+	
+	FileOutBinary file(fileSave);
+	if (!file.IsOpen())
+		return false;
+	
+	UVector<int> cols;
+	GetSaveIds(ids, cols);
+	if (cols.IsEmpty())
+		return false;
+	
+	int NumChans = cols.size() - 1;
+	int NumRecs = GetNumData();
+	const UVector<double> &time = dataOut[0];
+	
+	double TimeIncr = NumRecs > 1 ? (time[NumRecs-1] - time[0])/(NumRecs - 1) : 0;
+	bool constStep = TimeIncr > 0;
+	for (int idt = 1; idt < NumRecs && constStep; ++idt)
+		if (abs(time[idt] - time[0] - TimeIncr*idt) > 1E-3*TimeIncr)
+			constStep = false;
+	
+	int ChanLen = 10;
+	for (int c : cols)
+		ChanLen = max(ChanLen, parameters[c].GetCount(), units[c].GetCount() + 2);
+	bool chanLenIn = constStep && ChanLen > 10 && ChanLen <= std::numeric_limits<int16>::max();
+	if (!chanLenIn)
+		ChanLen = 10;
+	bool compressed = !constStep || chanLenIn;
+	
+	if (chanLenIn) {
+		file.Write(int16(FILETYPE::ChanLen_In));
+		file.Write(int16(ChanLen));
+	} else
+		file.Write(int16(constStep ? FILETYPE::NoCompressWithoutTime : FILETYPE::WithTime));
+	file.Write(int32(NumChans));
+	file.Write(int32(NumRecs));
+	
+	double TimeScl = 1, TimeOff = 0;
+	Buffer<float> ColScl, ColOff;
+	if (constStep) {
+		file.Write(double(time[0]));
+		file.Write(TimeIncr);
+	} else {
+		double tmin = Null, tmax = Null;
+		for (double t : time) {
+			tmin = IsNull(tmin) ? t : min(tmin, t);
+			tmax = IsNull(tmax) ? t : max(tmax, t);
 		}
+		if (tmax > tmin)
+			TimeScl = (double(std::numeric_limits<int32>::max()) - std::numeric_limits<int32>::lowest())/(tmax - tmin);
+		TimeOff = std::numeric_limits<int32>::lowest() - tmin*TimeScl;
+		file.Write(TimeScl);
+		file.Write(TimeOff);
 	}
+	if (compressed) {
+		const double intMin = std::numeric_limits<int16>::lowest(), intMax = std::numeric_limits<int16>::max();
+		ColScl.Alloc(NumChans);
+		ColOff.Alloc(NumChans);
+		CoPartition(0, NumChans, [&](int ic0, int ic1) {
+			for (int ic = ic0; ic < ic1; ++ic) {
+				int col = cols[ic+1];
+				double mn = Null, mx = Null;
+				for (int idt = 0; idt < min(GetNumData(col), NumRecs); ++idt) {
+					double v = GetVal(idt, col);
+					if (!IsNull(v)) {
+						mn = IsNull(mn) ? v : min(mn, v);
+						mx = IsNull(mx) ? v : max(mx, v);
+					}
+				}
+				if (IsNull(mn)) 
+					mn = mx = 0;
+				ColScl[ic] = float(mx > mn ? (intMax - intMin)/(mx - mn) : 1);
+				ColOff[ic] = float(intMin - mn*ColScl[ic]);
+			}
+		});
+		file.Write(ColScl.begin(), sizeof(float)*NumChans);
+		file.Write(ColOff.begin(), sizeof(float)*NumChans);
+	}
+	
+	String desc = "Saved by BEMRosetta";
+	file.Write(int32(desc.GetCount()));
+	file.Write(desc.begin(), desc.GetCount());
+	
+	auto WriteChars = [&](String str) {
+		str = str.Left(ChanLen);
+		str.Cat(' ', ChanLen - str.GetCount());
+		file.Write(str.begin(), ChanLen);
+	};
+	for (int c : cols)
+		WriteChars(parameters[c]);
+	for (int c : cols)
+		WriteChars("(" + units[c] + ")");
+	
+	if (!constStep) {
+		Buffer<int32> bufferTime(NumRecs);
+		for (int idt = 0; idt < NumRecs; ++idt)
+			bufferTime[idt] = int32(BetweenVal(fround(time[idt]*TimeScl + TimeOff), 
+					double(std::numeric_limits<int32>::lowest()), double(std::numeric_limits<int32>::max())));
+		file.Write(bufferTime.begin(), sizeof(int32)*size_t(NumRecs));
+	}
+	
+	if (!compressed) 
+		SaveOutbBody<double>(file, *this, cols, NumRecs, [](int, double v) {return v;}, fileSave, Status);
+	else 
+		SaveOutbBody<int16>(file, *this, cols, NumRecs, [&](int ic, double v) {
+			if (IsNull(v))
+				return std::numeric_limits<int16>::lowest();
+			return int16(BetweenVal(fround(v*ColScl[ic] + ColOff[ic]), 
+					double(std::numeric_limits<int16>::lowest()), double(std::numeric_limits<int16>::max())));
+		}, fileSave, Status);
 	return true;
 }
 
+String FastOut::BenchmarkSave(String folder, int &num) {
+	String base = AFX(folder, "benchSave");
+	
+	auto TimeSave = [&](String ext) {
+		TimeStop t;
+		if (!Save(base + ext, Null, ext, ";"))
+			throw Exc(F(t_("Impossible to save '%s'"), base + ext));
+		return t.Seconds();
+	};
+	double tOut = TimeSave(".out");
+	double tCsv = TimeSave(".csv");
+	double tOutb = TimeSave(".outb");
+	
+	// The previous writer, row by row, saves the references for the text files
+	UnpackSingle();
+	auto SaveRef = [&](String ext, String sep, int numDigits) {
+		String fileRef = base + "_ref" + ext;
+		{
+			FileOut data(fileRef);
+			if (!data)
+				throw Exc(F(t_("Impossible to save '%s'"), fileRef));
+			int numParams = min(dataOut.size(), parameters.size());
+			if (ext == ".out") {
+				data << "\n\n\n\n\n\n";
+				for (int idparam = 0; idparam < numParams; ++idparam) {
+					if (idparam > 0)
+						data << sep;
+					data << parameters[idparam];
+				}
+				data << "\n";
+				for (int idparam = 0; idparam < numParams; ++idparam) {
+					if (idparam > 0)
+						data << sep;
+					data << "(" << units[idparam] << ")";
+				}
+			} else {
+				for (int idparam = 0; idparam < numParams; ++idparam) {
+					if (idparam > 0)
+						data << sep;
+					data << parameters[idparam] << " [" << units[idparam] << "]";
+				}
+			}
+			data << "\n";
+			int numData = GetNumData();
+			for (int idtime = 0; idtime < numData; ++idtime) {
+				if (idtime > 0)
+					data << "\n";
+				for (int idparam = 0; idparam < numParams; ++idparam) {
+					if (idparam > 0)
+						data << sep;
+					if (dataOut[idparam].size() > idtime)
+						data << FDS(dataOut[idparam][idtime], numDigits, false);
+				}
+			}
+		}
+		if (LoadFile(base + ext) != LoadFile(fileRef))
+			throw Exc(F(t_("Saved '%s' is different than the one from the row by row writer"), base + ext));
+	};
+	SaveRef(".out", "\t", 10);
+	SaveRef(".csv", ";", 15);
+	
+	FastOut loaded;
+	loaded.derived = false;			// The derived channels of this file are already saved
+	String error = loaded.Load(base + ".outb", Null);
+	if (!error.IsEmpty())
+		throw Exc(error);
+	num = loaded.GetParameterCount();
+	if (num != GetParameterCount() || loaded.GetNumData() != GetNumData())
+		throw Exc(t_("Channels loaded from the saved .outb are different"));
+	
+	enum FILETYPE {WithTime = 1, WithoutTime, NoCompressWithoutTime, ChanLen_In};
+	int16 fileType;
+	{
+		FileInBinary fin(base + ".outb");
+		fileType = fin.Read<int16>();
+	}
+	bool compressed = fileType != FILETYPE::NoCompressWithoutTime;	// Saved as int16
+	int chanLen = fileType == FILETYPE::WithTime ? 10 : INT_MAX;	// Only variable time step cuts the names
+	for (int i = 0; i < num; ++i) {
+		if (ToLower(loaded.GetParameter(i)) != ToLower(GetParameter(i).Left(chanLen)))
+			throw Exc(F(t_("Channel '%s' loaded from the saved .outb is different"), GetParameter(i)));
+		if (i == 0)
+			continue;
+		double mn = Null, mx = Null;
+		for (int idt = 0; idt < GetNumData(i); ++idt) {
+			double v = GetVal(idt, i);
+			if (!IsNull(v)) {
+				mn = IsNull(mn) ? v : min(mn, v);
+				mx = IsNull(mx) ? v : max(mx, v);
+			}
+		}
+		double tol = compressed ? 2*(mx - mn)/std::numeric_limits<uint16>::max() + 1E-6*max(abs(mn), abs(mx)) : 0;
+		for (int idt = 0; idt < GetNumData(i); ++idt) {
+			double v = GetVal(idt, i);
+			if (!IsNull(v) && abs(loaded.GetVal(idt, i) - v) > tol)
+				throw Exc(F(t_("Channel '%s' loaded from the saved .outb is different at time %f"), GetParameter(i), GetVal(idt, 0)));
+		}
+	}
+	
+	String ret = F(t_("%d channels of %d samples"), num, GetNumData());
+	ret << "\n" << F(t_(".out:  %8.3f ms, %.1f MB/s"),  tOut*1000,  GetFileLength(base + ".out")/max(tOut, 1E-9)/1E6);
+	ret << "\n" << F(t_(".csv:  %8.3f ms, %.1f MB/s"),  tCsv*1000,  GetFileLength(base + ".csv")/max(tCsv, 1E-9)/1E6);
+	ret << "\n" << F(t_(".outb: %8.3f ms, %.1f MB/s"), tOutb*1000, GetFileLength(base + ".outb")/max(tOutb, 1E-9)/1E6);
+	return ret;
+}
+
 String FastOut::LoadOutb(String file, Function <bool(String, int)> Status) {
 	Clear();
 	
@@ -560,30 +1046,18 @@ bool FastOut::SaveCsv(String fileSave, Function <bool(String, int)> Status, Stri
 			
 	if (sep.IsEmpty())
 		sep = ";";
-	for (int idparam = 0; idparam < min(dataOut.size(), parameters.size()); ++idparam) {
-		if (idparam == 0 || ids.IsEmpty() || Find(ids, idparam) >= 0) {
-			if (idparam > 0)
-				data << sep;
-			data << parameters[idparam] << " [" << units[idparam] << "]";
-		}
+	
+	UVector<int> cols;
+	GetSaveIds(ids, cols);
+	
+	for (int i = 0; i < cols.size(); ++i) {
+		if (i > 0)
+			data << sep;
+		data << parameters[cols[i]] << " [" << units[cols[i]] << "]";
 	}
 	data << "\n";
-	int num = GetNumData();
-	for (int idtime = 0; idtime < num; ++idtime) {
-	    if (Status && !(idtime%1000) && !Status(F(t_("Saving '%s'"), ::GetFileName(fileSave)), (100*idtime)/num))
-			throw Exc(t_("Stop by user"));
-		if (idtime > 0)
-			data << "\n";
-		for (int idparam = 0; idparam < min(dataOut.size(), parameters.size()); ++idparam) {
-			if (idparam == 0 || ids.IsEmpty() || Find(ids, idparam) >= 0) {
-				if (idparam > 0)
-					data << sep;
-				if (dataOut[idparam].size() > idtime)
-					data << FDS(dataOut[idparam][idtime], 15, false);
-			}
-		}
-	}
-	return true;//SaveFile(fileSave, data);
+	SaveRows(data, cols, sep, 15, fileSave, Status);
+	return true;
 }
 
 void FastOut::AfterLoad() {
@@ -594,19 +1068,13 @@ void FastOut::AfterLoad() {
 	for (int i = 0; i < units.size(); ++i)
 		unitsd << ToLower(units[i]);
 
+	numRaw = parameters.size();
+
 	const char *strPos[] = {"PtfmSurge", "PtfmSway", "PtfmHeave", "PtfmRoll", "PtfmPitch", "PtfmYaw"};
-	const char *strVel[] = {"PtfmTVxi",  "PtfmTVyi", "PtfmTVzi", "PtfmRVxi",  "PtfmRVyi", "PtfmRVzi"};
-	const char *strAcc[] = {"PtfmTAxi",  "PtfmTAyi", "PtfmTAzi", "PtfmRAxi",  "PtfmRAyi", "PtfmRAzi"};
 	
 	idPos.SetCount(6);
 	for (int i = 0; i < 6; ++i)
 		idPos[i] = GetParameterX(strPos[i]);
-	UVector<int> idVel(6);
-	for (int i = 0; i < 6; ++i)
-		idVel[i] = GetParameterX(strVel[i]);
-	UVector<int> idAcc(6);
-	for (int i = 0; i < 6; ++i)
-		idAcc[i] = GetParameterX(strAcc[i]);
 	
 	idsurge = idPos[0];
 	idsway  = idPos[1];
@@ -617,15 +1085,81 @@ void FastOut::AfterLoad() {
 	idaz    = GetParameterX("Azimuth");	
 	idnacyaw = GetParameterX("NacYaw");
 	
+	if (derived)
+		CalcDerived();
+	
+	// Store the mooring lines points to render or check them
+	mooringPointIds.Clear();
+	UVector<UVector<int>> pointNames;
+	UVector<int> lineNames;
+	
+	SortedIndex<String> lst = GetParameterList("L*N*p");
+		
+	for (int i = 0; i < lst.size(); i++) {
+		int lineName  = ScanInt(lst[i].Mid(1));
+		int lineId = Find(lineNames, lineName);
+		if (lineId < 0) {
+			pointNames.Add();
+			mooringPointIds.Add();
+			lineNames << lineName;
+			lineId = lineNames.size() - 1;
+		}
+		
+		int pos = lst[i].FindAfter("N");		// 'N' has to be because of "L*N*p"
+		int pointName = ScanInt(lst[i].Mid(pos));
+		int pointId = Find(pointNames[lineId], pointName);
+		if (pointId < 0) {
+			mooringPointIds[lineId].Add();
+			pointNames[lineId] << pointName;
+			pointId = pointNames[lineId].size() - 1;
+		}
+		FastOut::id3d &id = mooringPointIds[lineId][pointId];
+		
+		switch(*lst[i].Last()) {
+		case 'X':	id.x = GetParameterX(lst[i]);	break;
+		case 'Y':	id.y = GetParameterX(lst[i]);	break;
+		case 'Z':	id.z = GetParameterX(lst[i]);	break;
+		}
+	}
+	for (int i = 0; i < lineNames.size(); ++i) {
+		UVector<int> order = GetSortOrderX(pointNames[i]);
+		mooringPointIds[i] = ApplyIndex(mooringPointIds[i], order);
+	}
+}
+
+void FastOut::CalcDerived(bool block) {
+	UnpackSingle();		// Derived channels are calculated in double precision
+	
+	if (IsNull(numRaw))
+		numRaw = parameters.size();
+	parameters .SetCount(numRaw);		// Removes the derived channels of a previous call
+	units	   .SetCount(numRaw);
+	parametersd.SetCount(numRaw);
+	unitsd	   .SetCount(numRaw);
+	dataOut	   .SetCount(numRaw);
+	pyramids   .SetCount(min(pyramids.size(), numRaw));
+	
+	const char *strPos[] = {"PtfmSurge", "PtfmSway", "PtfmHeave", "PtfmRoll", "PtfmPitch", "PtfmYaw"};
+	const char *strVel[] = {"PtfmTVxi",  "PtfmTVyi", "PtfmTVzi", "PtfmRVxi",  "PtfmRVyi", "PtfmRVzi"};
+	const char *strAcc[] = {"PtfmTAxi",  "PtfmTAyi", "PtfmTAzi", "PtfmRAxi",  "PtfmRAyi", "PtfmRAzi"};
+	UVector<int> idVel(6);
+	for (int i = 0; i < 6; ++i)
+		idVel[i] = GetParameterX(strVel[i]);
+	UVector<int> idAcc(6);
+	for (int i = 0; i < 6; ++i)
+		idAcc[i] = GetParameterX(strAcc[i]);
+	
 	UVector<Point3D> ppp;
 	if (Min(idPos) >= 0) {
 		ppp.SetCount(GetNumData());
 		aff.SetCount(GetNumData());
-		for (int it = 0; it < GetNumData(); ++it) {
-			ppp[it] = Point3D(GetVal(it, idsurge), GetVal(it, idsway), GetVal(it, idheave));
-			aff[it] = GetTransform000(ppp[it], 
-									  Value3D(ToRad(GetVal(it, idroll)), ToRad(GetVal(it, idpitch)), ToRad(GetVal(it, idyaw))));
-		}
+		CoPartition(0, GetNumData(), [&](int it0, int it1) {
+			for (int it = it0; it < it1; ++it) {
+				ppp[it] = Point3D(GetVal(it, idsurge), GetVal(it, idsway), GetVal(it, idheave));
+				aff[it] = GetTransform000(ppp[it], 
+										  Value3D(ToRad(GetVal(it, idroll)), ToRad(GetVal(it, idpitch)), ToRad(GetVal(it, idyaw))));
+			}
+		});
 	}
 	
 	UVector<Velocity6D> www;
@@ -711,15 +1245,18 @@ void FastOut::AfterLoad() {
 	dataOut	   .SetCount(sz + numCalcParams + pointParams.size()*numPointParams);
 	
 	int idc = 0;	
+	UVector<CalcParam *> enabled;
 	for (CalcParam *cc : calcParams) {
 		CalcParam &c = *cc;
 		if (c.IsEnabled()) {
+			enabled << cc;
 			c.id = sz + idc++;
 			parameters[c.id] = c.name;
 			units[c.id] = c.units;
 			parametersd[c.id] = ToLower(c.name);
 			unitsd[c.id] = ToLower(c.units);
-		}
+		} else
+			c.id = -1;
 	}
 	sz += numCalcParams;
 	
@@ -767,11 +1304,7 @@ void FastOut::AfterLoad() {
 			for (int ip = 0; ip < 3; ++ip)
 				dataOut[id + iip++].SetCount(GetNumData());
 	}
-	for (int idt = 0; idt < GetNumData(); ++idt) {
-		for (CalcParam *c : calcParams) {	
-			if (c->IsEnabled()) 
-				dataOut[c->id][idt] = c->Calc(idt);
-		}
+	auto CalcPoints = [&](int idt) {
 		Velocity6D vel = Null;
 		if (!www.IsEmpty())
 			vel = clone(www[idt]);
@@ -799,50 +1332,163 @@ void FastOut::AfterLoad() {
 				}
 			}
 		}
+	};
+	if (block) {
+		CoPartition(0, GetNumData(), [&](int idt0, int idt1) {
+			for (CalcParam *c : enabled)
+				c->CalcBlock(idt0, idt1);
+			for (int idt = idt0; idt < idt1; ++idt)
+				CalcPoints(idt);
+		});
+	} else {
+		for (int idt = 0; idt < GetNumData(); ++idt) {
+			for (CalcParam *c : calcParams) {	
+				if (c->IsEnabled()) 
+					dataOut[c->id][idt] = c->Calc(idt);
+			}
+			CalcPoints(idt);
+		}
 	}
+	aff.Clear();
 	
-	// Store the mooring lines points to render or check them
-	mooringPointIds.Clear();
-	UVector<UVector<int>> pointNames;
-	UVector<int> lineNames;
+	if (single)
+		PackSingle();
+}
+
+void MinMaxPyramid::Build(const UVector<double> &y) {
+	Clear();
+	count = y.size();
+	if (count == 0)
+		return;
 	
-	SortedIndex<String> lst = GetParameterList("L*N*p");
-		
-	for (int i = 0; i < lst.size(); i++) {
-		int lineName  = ScanInt(lst[i].Mid(1));
-		int lineId = Find(lineNames, lineName);
-		if (lineId < 0) {
-			pointNames.Add();
-			mooringPointIds.Add();
-			lineNames << lineName;
-			lineId = lineNames.size() - 1;
-		}
-		
-		int pos = lst[i].FindAfter("N");		// 'N' has to be because of "L*N*p"
-		int pointName = ScanInt(lst[i].Mid(pos));
-		int pointId = Find(pointNames[lineId], pointName);
-		if (pointId < 0) {
-			mooringPointIds[lineId].Add();
-			pointNames[lineId] << pointName;
-			pointId = pointNames[lineId].size() - 1;
+	auto Less    = [&](int a, int b) {return a >= 0 && (b < 0 || y[a] < y[b]);};	// -1 is an empty block
+	auto Greater = [&](int a, int b) {return a >= 0 && (b < 0 || y[a] > y[b]);};
+	
+	int nb = (count + BASE - 1)/BASE;
+	UVector<int> &mn = imin.Add(), &mx = imax.Add();
+	mn.SetCount(nb);
+	mx.SetCount(nb);
+	for (int ib = 0; ib < nb; ++ib) {
+		int i0 = ib*BASE, i1 = min(i0 + BASE, count);
+		int a = -1, b = -1;
+		for (int i = i0; i < i1; ++i) {
+			if (IsNull(y[i]))
+				continue;
+			if (Less(i, a))
+				a = i;
+			if (Greater(i, b))
+				b = i;
 		}
-		FastOut::id3d &id = mooringPointIds[lineId][pointId];
-		
-		switch(*lst[i].Last()) {
-		case 'X':	id.x = GetParameterX(lst[i]);	break;
-		case 'Y':	id.y = GetParameterX(lst[i]);	break;
-		case 'Z':	id.z = GetParameterX(lst[i]);	break;
+		mn[ib] = a;
+		mx[ib] = b;
+	}
+	while (imin.Top().size() > 1) {
+		const UVector<int> &pmn = imin.Top(), &pmx = imax.Top();
+		int n = (pmn.size() + 1)/2;
+		UVector<int> nmn, nmx;
+		nmn.SetCount(n);
+		nmx.SetCount(n);
+		for (int ib = 0; ib < n; ++ib) {
+			int j = 2*ib, k = min(j + 1, pmn.size() - 1);
+			nmn[ib] = Less(pmn[k], pmn[j]) ? pmn[k] : pmn[j];
+			nmx[ib] = Greater(pmx[k], pmx[j]) ? pmx[k] : pmx[j];
 		}
+		imin.Add(pick(nmn));
+		imax.Add(pick(nmx));
 	}
-	for (int i = 0; i < lineNames.size(); ++i) {
-		UVector<int> order = GetSortOrderX(pointNames[i]);
-		mooringPointIds[i] = ApplyIndex(mooringPointIds[i], order);
+}
+
+void MinMaxPyramid::Get(int id0, int id1, int num, UVector<int> &ids) const {
+	ids.Clear();
+	id0 = max(id0, 0);
+	id1 = min(id1, count - 1);
+	if (id1 < id0)
+		return;
+	
+	int n = id1 - id0 + 1;
+	num = max(num, 1);
+	int bs = n/num;
+	if (bs < BASE || imin.IsEmpty()) {
+		ids.SetCount(n);
+		for (int i = 0; i < n; ++i)
+			ids[i] = id0 + i;
+		return;
 	}
+	int maxLevel = 0;
+	while (maxLevel + 1 < imin.size() && (BASE << (maxLevel + 1)) <= bs)
+		maxLevel++;
 	
-	aff.Clear();
+	auto Add = [&](int id) {
+		if (ids.IsEmpty() || id > ids.Top())
+			ids << id;
+	};
+	// The range is covered exactly with the largest aligned blocks, and the unaligned ends sample by sample
+	ids.Reserve(2*(n/(BASE << maxLevel)) + 4*(maxLevel + BASE));
+	for (int i = id0; i <= id1;) {
+		int l = -1;
+		if (i%BASE == 0) {
+			l = maxLevel;
+			while (l >= 0 && (i%(BASE << l) != 0 || i + (BASE << l) - 1 > id1))
+				l--;
+		}
+		if (l < 0) {
+			Add(i++);
+			continue;
+		}
+		int ib = i/(BASE << l);
+		int a = imin[l][ib], b = imax[l][ib];
+		if (a >= 0) {
+			if (a > b)
+				Swap(a, b);
+			Add(a);
+			Add(b);
+		}
+		i += BASE << l;
+	}
+}
+
+void FastOut::BuildPyramid(int idparam) {
+	if (IsSingle(idparam)) {
+		UVector<double> d;
+		GetChannel(idparam, d);
+		pyramids[idparam].Build(d);
+	} else
+		pyramids[idparam].Build(dataOut[idparam]);
+}
+
+const MinMaxPyramid &FastOut::GetPyramid(int idparam) {
+	if (pyramids.size() != dataOut.size())
+		pyramids.SetCount(dataOut.size());
+	if (pyramids[idparam].GetCount() != GetNumData(idparam))
+		BuildPyramid(idparam);
+	return pyramids[idparam];
+}
+
+void FastOutSource::Init(FastOut &_fast, int _col, int _idBegin, int _num, double _xfactor) {
+	fast = &_fast;
+	col = _col;
+	pyramid = &_fast.GetPyramid(col);
+	time = _fast.GetUVector(0).begin();
+	idBegin = _idBegin;
+	num = _num;
+	xfactor = _xfactor;
+	SetView(Null, Null, 2000);
+}
+
+void FastOutSource::SetView(double xmin, double xmax, int pixels) {
+	int id0 = idBegin, id1 = idBegin + num - 1;
+	if (!IsNull(xmin) && !IsNull(xmax) && xfactor != 0 && num > 1) {		// Time is sorted
+		const double *t0 = time + idBegin, *t1 = time + idBegin + num;
+		id0 = max(idBegin, int(std::lower_bound(t0, t1, xmin/xfactor) - time) - 1);
+		id1 = min(idBegin + num - 1, int(std::upper_bound(t0, t1, xmax/xfactor) - time));
+	}
+	pyramid->Get(id0, id1, pixels, ids);
 }
 
 void FastOut::AppendLine(int idline, FastOut &fst) {
+	UnpackSingle();
+	fst.UnpackSingle();
+	
 	String strp = F("L%d", idline) + "N";
 	fst.parameters.Remove(0);
 	for (String &param : fst.parameters) {
@@ -867,11 +1513,14 @@ void FastOut::Clear() {
 	parametersd.Clear();	
 	unitsd.Clear();	
 	dataOut.Clear();
+	dataSingle.Clear();
+	pyramids.Clear();
 	descriptions.Clear();
 	Hx = Hz = Null;
 	idsurge = idsway = idheave = idroll = idpitch = idyaw = idaz = idnacyaw = Null;
 	TipRad = OverHang = ShftTilt = Precone = Twr2Shft = TowerHt = baseClearance = Null;
 	Hs = Tp = heading = Null;
+	numRaw = Null;
 }
 
 bool FastOut::IsEmpty() {
@@ -931,6 +1580,8 @@ void FastOut::SetVal(int idparam, double val) {
 		throw Exc("SetNextTime has to bec called before SetVal");
 	if (idparam < 0)
 		return;
+	if (IsSingle(idparam))
+		UnpackSingle(idparam);
 	auto &data = dataOut[idparam];
 	if (idActualTime < data.size()) {
 		data[idActualTime] = val;
@@ -989,6 +1640,140 @@ int FastOut::GetNumData() const {
 	return dataOut[0].size();
 }	
 	
+void FastOut::PackSingle() {
+	dataSingle.SetCount(dataOut.size());
+	CoPartition(1, max(1, dataOut.size()), [&](int i0, int i1) {
+		for (int i = i0; i < i1; ++i) {
+			UVector<double> &d = dataOut[i];
+			if (d.IsEmpty())
+				continue;
+			UVector<float> &f = dataSingle[i];
+			f.SetCount(d.size());
+			for (int idt = 0; idt < d.size(); ++idt)
+				f[idt] = ToSingle(d[idt]);
+			d.Clear();
+		}
+	});
+}
+
+void FastOut::UnpackSingle(int idparam) {
+	const UVector<float> &f = dataSingle[idparam];
+	UVector<double> &d = dataOut[idparam];
+	d.SetCount(f.size());
+	for (int idt = 0; idt < f.size(); ++idt)
+		d[idt] = ToDouble(f[idt]);
+	dataSingle[idparam].Clear();
+}
+
+void FastOut::UnpackSingle() {
+	CoPartition(0, dataSingle.size(), [&](int i0, int i1) {
+		for (int i = i0; i < i1; ++i)
+			if (IsSingle(i))
+				UnpackSingle(i);
+	});
+	dataSingle.Clear();
+}
+
+int64 FastOut::GetMemory() const {
+	int64 ret = 0;
+	for (const UVector<double> &d : dataOut)
+		ret += sizeof(double)*int64(d.GetAlloc());
+	for (const UVector<float> &f : dataSingle)
+		ret += sizeof(float)*int64(f.GetAlloc());
+	return ret;
+}
+
+void FastOut::GetChannel(int idparam, UVector<double> &data) const {
+	if (!IsSingle(idparam)) {
+		data = clone(dataOut[idparam]);
+		return;
+	}
+	const UVector<float> &f = dataSingle[idparam];
+	data.SetCount(f.size());
+	for (int idt = 0; idt < f.size(); ++idt)
+		data[idt] = ToDouble(f[idt]);
+}
+
+VectorXd FastOut::GetVector(int idparam) const {
+	if (!IsSingle(idparam)) {
+		const UVector<double> &d = dataOut[idparam];
+		VectorXd ret = Map<const VectorXd>(d, d.size());
+		return ret;
+	}
+	const UVector<float> &f = dataSingle[idparam];
+	VectorXd ret(f.size());
+	for (int idt = 0; idt < f.size(); ++idt)
+		ret(idt) = ToDouble(f[idt]);
+	return ret;
+}
+
+String FastOut::BenchmarkSingle(String file, int &num) {
+	auto TimeLoad = [&](FastOut &fast, bool single) {
+		fast.single = single;
+		fast.derived = false;
+		TimeStop t;
+		String error = fast.Load(file);
+		if (!error.IsEmpty())
+			throw Exc(error);
+		return t.Seconds();
+	};
+	FastOut dbl, sgl;
+	double tLoadDbl = TimeLoad(dbl, false);
+	double tLoadSgl = TimeLoad(sgl, true);
+	
+	if (dbl.GetParameterCount() != sgl.GetParameterCount() || dbl.GetNumData() != sgl.GetNumData())
+		throw Exc(t_("Channels loaded in single precision are different"));
+	
+	num = 0;
+	int numData = dbl.GetNumData();
+	double maxErr = 0;
+	for (int i = 0; i < dbl.GetParameterCount(); ++i) {
+		if (sgl.IsSingle(i))
+			num++;
+		double range = 0;
+		for (int idt = 0; idt < numData; ++idt)
+			if (!IsNull(dbl.GetVal(idt, i)))
+				range = max(range, abs(dbl.GetVal(idt, i)));
+		for (int idt = 0; idt < numData; ++idt) {
+			double a = dbl.GetVal(idt, i), b = sgl.GetVal(idt, i);
+			if (IsNull(a) != IsNull(b))
+				throw Exc(F(t_("Channel '%s' loaded in single precision is different in time %f"), dbl.GetParameter(i), dbl.GetVal(idt, 0)));
+			if (!IsNull(a) && range > 0)
+				maxErr = max(maxErr, abs(a - b)/range);
+		}
+	}
+	if (maxErr > 1E-6)
+		throw Exc(F(t_("Single precision error %G is too large"), maxErr));
+	
+	auto TimeQuery = [&](const FastOut &fast, double &sum) {
+		TimeStop t;
+		sum = 0;
+		for (int i = 1; i < fast.GetParameterCount(); ++i)
+			for (int idt = 0; idt < numData; ++idt)
+				sum += Nvl(fast.GetVal(idt, i), 0.);
+		return t.Seconds();
+	};
+	auto TimeVector = [&](const FastOut &fast) {
+		TimeStop t;
+		for (int i = 1; i < fast.GetParameterCount(); ++i)
+			fast.GetVector(i);
+		return t.Seconds();
+	};
+	double sumDbl, sumSgl;
+	double tQueryDbl = TimeQuery(dbl, sumDbl);
+	double tQuerySgl = TimeQuery(sgl, sumSgl);
+	double tVectorDbl = TimeVector(dbl);
+	double tVectorSgl = TimeVector(sgl);
+	
+	double memDbl = dbl.GetMemory()/1E6, memSgl = sgl.GetMemory()/1E6;
+	String ret = F(t_("%d channels of %d samples in single precision. Max. error %G of the channel range"), num, numData, maxErr);
+	ret << "\n" << F(t_("Memory:         double %9.3f MB, single %9.3f MB (%.0f%%)"), memDbl, memSgl, 100*memSgl/max(memDbl, 1E-9));
+	ret << "\n" << F(t_("Load:           double %9.3f ms, single %9.3f ms"), tLoadDbl*1000, tLoadSgl*1000);
+	ret << "\n" << F(t_("GetVal() scan:  double %9.3f ms, single %9.3f ms"), tQueryDbl*1000, tQuerySgl*1000);
+	ret << "\n" << F(t_("GetVector():    double %9.3f ms, single %9.3f ms"), tVectorDbl*1000, tVectorSgl*1000);
+	return ret;
+}
+
 SortedIndex<String> FastOut::GetParameterList(String filter) {
 	SortedIndex<String> list;
 	
@@ -1043,10 +1828,15 @@ SortedVectorMap<String, String> FastOut::GetList(String filterParam, String filt
 	return list;
 }
 
-void Calc(const UArray<FastOut> &dataFast, const ParameterMetrics &params0, ParameterMetrics &params, double start, double end, UVector<UVector<Value>> &table, Function <bool(String, int)> Status) {
-	table.Clear();
-	
-	// Gets the real set of parameters taking into account *
+static String GetEquation(String eq) {
+	int id = eq.FindAfter(":");
+	if (id >= 0)
+		return Trim(eq.Mid(id));
+	return eq;
+}
+
+// Adds to params the real set of parameters of params0 in fast, taking into account *
+static void CalcParams(const FastOut &fast, const ParameterMetrics &params0, ParameterMetrics &params) {
 	auto FindParam = [&](String strpartofind)->bool {
 		for (const ParameterMetric &param : params.params) {
 			if (ToLower(strpartofind) == ToLower(param.name))
@@ -1055,230 +1845,106 @@ void Calc(const UArray<FastOut> &dataFast, const ParameterMetrics &params0, Para
 		return false;
 	};
 	
-	auto GetEquation = [&](String eq) {
-		int id = eq.FindAfter(":");
-		if (id >= 0)
-			return Trim(eq.Mid(id));
-		return eq;
-	};
-	
-	for (const FastOut &fast : dataFast) { 
-		for (const ParameterMetric &p0 : params0.params) {
-			UVector<String> names = fast.FindParameterMatchStr(p0.name);
-			for (String name : names) {
-				if (!FindParam(name)) {
-					ParameterMetric &param = params.params.Add();
-					param = clone(p0);
-					param.name = name;
-				}
+	for (const ParameterMetric &p0 : params0.params) {
+		UVector<String> names = fast.FindParameterMatchStr(p0.name);
+		for (String name : names) {
+			if (!FindParam(name)) {
+				ParameterMetric &param = params.params.Add();
+				param = clone(p0);
+				param.name = name;
 			}
-			if (names.IsEmpty() && !FindParam(p0.name)) {
-				EvalExprX exp;
-		    	exp.WhenGetVariableId = [&](const char *name) {
-		    		String nam(name);
-		    		nam.Replace("$", "\\");
-		    		return fast.GetParameterX(nam);
-		    	};
-		    	String name = p0.name;
-		    	name.Replace("\\", "$");
-				PostFixOperation op = exp.Get(GetEquation(name));
-				if (!op.IsEmpty()) {
-					ParameterMetric &param = params.params.Add();
-					param = clone(p0);
-				}
+		}
+		if (names.IsEmpty() && !FindParam(p0.name)) {
+			EvalExprX exp;
+			exp.WhenGetVariableId = [&](const char *name) {
+				String nam(name);
+				nam.Replace("$", "\\");
+				return fast.GetParameterX(nam);
+			};
+			String name = p0.name;
+			name.Replace("\\", "$");
+			PostFixOperation op = exp.Get(GetEquation(name));
+			if (!op.IsEmpty()) {
+				ParameterMetric &param = params.params.Add();
+				param = clone(p0);
 			}
 		}
 	}
+}
+
+// Row of the metrics of fast. If fullData and fullTime are not null, the series are appended to them for the Total row
+static void CalcRow(const FastOut &fast, const ParameterMetrics &params, double start, double end, UVector<Value> &t, 
+					UVector<UVector<double>> *fullData, UVector<double> *fullTime) {
+	EvalExprX exp;
+	int idtime = 0;
+	exp.WhenGetVariableId = [&](const char *name) {
+		String nam(name);
+		nam.Replace("$", "\\");
+		return fast.GetParameterX(nam);
+	};
+	exp.WhenGetVariableValue = [&](int id) 			{return fast.GetVal(idtime, id);};
+
+	int idBegin = fast.GetIdTime(start);
+	int num = fast.GetNumData();
+	if (IsNull(idBegin) || idBegin >= num) 
+		throw Exc(t_("Bad start time"));
+
+	int idEnd = fast.GetIdTime(end);
+	if (!IsNull(idEnd)) {
+		if (idEnd >= num) 
+			throw Exc(t_("Bad end time"));
+	} else
+		idEnd = num-1;
 	
-	// Does the real job
-	UVector<UVector<double>> fullData(params.params.size());
-	UVector<double> fullTime;
-	for (int i = 0; i < dataFast.size(); ++i) {
-		const FastOut &fast = dataFast[i];
-		if (Status && !Status(t_("Calculating"), int(100*(i+1.)/dataFast.size())))
-			throw Exc(t_("Stop by user"));
-				
-		EvalExprX exp;
-		int idtime = 0;
-    	exp.WhenGetVariableId = [&](const char *name) {
-    		String nam(name);
-		    nam.Replace("$", "\\");
-    		return fast.GetParameterX(nam);
-    	};
-    	exp.WhenGetVariableValue = [&](int id) 			{return fast.GetVal(idtime, id);};
-    
-		int idBegin = fast.GetIdTime(start);
-		int num = fast.GetNumData();
-		if (IsNull(idBegin) || idBegin >= num) 
-			throw Exc(t_("Bad start time"));
-
-		int idEnd = fast.GetIdTime(end);
-		if (!IsNull(idEnd)) {
-			if (idEnd >= num) 
-				throw Exc(t_("Bad end time"));
-		} else
-			idEnd = num-1;
-		
-		if (idBegin >= idEnd)
-			throw Exc(t_("Begin has to be before end time"));
-		
-		VectorXd time = fast.GetVector(0).segment(idBegin, idEnd - idBegin);
-		if (!fullTime.IsEmpty()) {
-			double delta = fullTime[fullTime.size()-1] - fullTime[fullTime.size()-2];
-			time.array() += fullTime[fullTime.size()-1] + delta;
+	if (idBegin >= idEnd)
+		throw Exc(t_("Begin has to be before end time"));
+	
+	VectorXd time = fast.GetVector(0).segment(idBegin, idEnd - idBegin);
+	if (fullTime) {
+		if (!fullTime->IsEmpty()) {
+			double delta = (*fullTime)[fullTime->size()-1] - (*fullTime)[fullTime->size()-2];
+			time.array() += (*fullTime)[fullTime->size()-1] + delta;
 		}
 		UVector<double> ntime;
 		Copy(time, ntime);
-		fullTime.Append(ntime);
+		fullTime->Append(ntime);
+	}
+	
+	t << fast.GetFileName();			
+	t << fast.GetVal(idBegin, 0);
+	t << fast.GetVal(idEnd, 0);
+	for (int ip = 0; ip < params.params.size(); ip++) {
+		auto &param = params.params[ip];
+		if (param.metrics.size() < 1)
+			throw Exc(t_("Wrong number of parameters"));
 		
-		UVector<Value> &t = table.Add();
+		VectorXd data;
 		
-		t << fast.GetFileName();			
-		t << fast.GetVal(idBegin, 0);
-		t << fast.GetVal(idEnd, 0);
-		for (int ip = 0; ip < params.params.size(); ip++) {
-			auto &param = params.params[ip];
-			if (param.metrics.size() < 1)
-				throw Exc(t_("Wrong number of parameters"));
-			
-			VectorXd data;
-			
-			int id = fast.GetParameterX(param.name);
-			if (id < 0) {
-				try {
-					String name = param.name;
-		    		name.Replace("\\", "$");
-					PostFixOperation op = exp.Get(GetEquation(name));
-					data.resize(idEnd - idBegin);
-					for (int i = 0; i < data.size(); ++i) {
-						idtime = i + idBegin;
-						data[i] = exp.Eval(op);
-					}
-					id = 0;
-				} catch (...) {
-				}
-			} else
-				data = fast.GetVector(id).segment(idBegin, idEnd - idBegin);
-
-			if (id < 0) {
-				for (int i = 0; i < param.metrics.size(); i++) 
-					t << "";
-			} else {
-				AppendX(data, fullData[ip]);
-
-				for (int i = 0; i < param.metrics.size(); i++) {
-					String str = param.metrics[i];
-					str.Replace("(", ",");
-					str.Replace(")", ",");
-					UVector<String> pars = Split(str, ",");
-					Trim(pars);
-					if (pars.IsEmpty())
-						continue;
-					String stat = pars[0];
-					double val = Null;
-					if (stat == "mean" || stat == "avg") 
-						val = data.mean();
-					else if (stat == "min") 
-						val = data.minCoeff();
-					else if (stat == "max") 
-						val = data.maxCoeff();
-					else if (stat == "rangeminmax") 
-						val = data.maxCoeff() - data.minCoeff();
-					else if (stat == "maxval") { 
-						double mx = data.maxCoeff();
-						double mn = data.minCoeff();
-						if (abs(mx) > abs(mn))
-							val = mx;
-						else
-							val = mn;
-					} else if (stat == "maxmean") 
-						val = data.maxCoeff() - data.mean();
-					else if (stat == "minmean") 
-						val = data.minCoeff() - data.mean();
-					else if (stat == "std" || stat == "stddev") 
-						val = sqrt((data.array() - data.mean()).square().sum() / (data.size() - 1));
-					else if (stat == "amplitude") {
-						bool onlyFFT = true;
-						double r2Max = 0.95;
-						double T, H;
-						GetWaveRegularAmplitude(fast, T, H);
-						val = GetRAO(data, time, T, onlyFFT, r2Max);
-					} else if (stat == "rao") {
-						bool onlyFFT = true;
-						double r2Max = 0.95;
-						double T, H;
-						GetWaveRegularAmplitude(fast, T, H);
-						val = GetRAO(data, time, T, onlyFFT, r2Max);
-						val /= H;
-					} else if (stat == "rao_mean") 
-						val = data.tail(data.size()/2).mean();	// mean of the half end
-					else if (stat == "percentile") {
-						if (pars.size() == 2) {
-							EigenVector v(data, 0, 1);
-							val = v.PercentileValY(ScanDouble(pars[1]));	
-						} else if (pars.size() == 3) {
-							EigenVector v(data, 0, 1);
-							val = v.PercentileValRangeY(ScanDouble(pars[1]), ScanDouble(pars[2]));	
-						} else
-							throw Exc("'percentile' requires one or two arguments");
-					} else if (stat == "weibull") {
-						if (pars.size() != 2)
-							throw Exc("'weibull' requires one argument");
-						EigenVector v(data, 0, 1);
-						val = v.PercentileWeibullValY(ScanDouble(pars[1]));
-					} else if (stat == "td") {
-						if (pars.size() != 4)
-							throw Exc("'td' requires three arguments");
-						double deltaTime = StringToSeconds(pars[1]);
-						double gamma_mean = ScanDouble(pars[2]);
-						double gamma_dyn = ScanDouble(pars[3]);
-						
-						UVector<double> maxs;
-						int id0 = 0;
-						double t0 = time[0];
-						for (int i = 0; i < time.size(); ++i) {
-							if (time[i] - t0 >= deltaTime) {
-								maxs << data.segment(id0, i - id0 + 1).maxCoeff();
-								id0 = i+1;
-								t0 = time[id0];
-							}
-						}
-						if (Last(time) - t0 >= deltaTime*0.75)
-							maxs << data.segment(id0, data.size() - id0).maxCoeff();
-						if (maxs.size() > 1) {
-							double mean = data.mean();
-							double mpm = Avg(maxs) - 0.45*StdDev(maxs, mean);
-							double tc_dyn = mpm - mean;
-							val = mean*gamma_mean + tc_dyn*gamma_dyn; 		// From DNV-OS-E301
-						}
-					} else if (stat == "demo") {
-						if (pars.size() != 3)
-							throw Exc("'demo' requires two arguments");
-						val = ScanDouble(pars[1]) + ScanDouble(pars[2]);
-					} else
-						throw Exc(F(t_("Unknown '%s' statistic in parameter '%s'"), stat, param.name));
-					
-					t << val;//F("%" + format, val);
+		int id = fast.GetParameterX(param.name);
+		if (id < 0) {
+			try {
+				String name = param.name;
+	    		name.Replace("\\", "$");
+				PostFixOperation op = exp.Get(GetEquation(name));
+				data.resize(idEnd - idBegin);
+				for (int i = 0; i < data.size(); ++i) {
+					idtime = i + idBegin;
+					data[i] = exp.Eval(op);
 				}
+				id = 0;
+			} catch (...) {
 			}
-		}
-	}
-	if (dataFast.size() > 1) {
-		UVector<Value> &t = table.Add();
-		t << t_("Total");
-		t << t_("-");
-		t << t_("-");
-		VectorXd data(table.size()-1), time(table.size()-1);
-		int col = 3;
-		for (int ip = 0; ip < params.params.size(); ip++) {
-			const ParameterMetric &param = params.params[ip];
-		
+		} else
+			data = fast.GetVector(id).segment(idBegin, idEnd - idBegin);
+
+		if (id < 0) {
+			for (int i = 0; i < param.metrics.size(); i++) 
+				t << "";
+		} else {
+			if (fullData)
+				AppendX(data, (*fullData)[ip]);
+
 			for (int i = 0; i < param.metrics.size(); i++) {
-				for (int row = 0; row < table.size()-1; ++row) {
-					data[row] = double(table[row][col]);
-					time[row] = double(table[row][2]) - double(table[row][1]);
-				}
-				col++;
 				String str = param.metrics[i];
 				str.Replace("(", ",");
 				str.Replace(")", ",");
@@ -1287,10 +1953,9 @@ void Calc(const UArray<FastOut> &dataFast, const ParameterMetrics &params0, Para
 				if (pars.IsEmpty())
 					continue;
 				String stat = pars[0];
-					
 				double val = Null;
 				if (stat == "mean" || stat == "avg") 
-					val = (data.array()*time.array()).sum() / time.sum();
+					val = data.mean();
 				else if (stat == "min") 
 					val = data.minCoeff();
 				else if (stat == "max") 
@@ -1304,44 +1969,41 @@ void Calc(const UArray<FastOut> &dataFast, const ParameterMetrics &params0, Para
 						val = mx;
 					else
 						val = mn;
-				} else if (stat == "maxmean") {
-					double mean = (data.array()*time.array()).sum() / time.sum();
-					val = data.maxCoeff() - mean;
-				} else if (stat == "minmean") { 
-					double mean = (data.array()*time.array()).sum() / time.sum();
-					val = data.minCoeff() - mean;
-				} else if (stat == "std" || stat == "stddev") {
-					VectorXd d = Map<VectorXd>(fullData[ip], fullData[ip].size());	
-					val = sqrt((d.array() - d.mean()).square().sum() / (d.size() - 1));
-				} else if (stat == "amplitude") 
-					val = Null;
-				else if (stat == "rao") 
-					val = Null;
-				else if (stat == "rao_mean") 
-					val = Null;
+				} else if (stat == "maxmean") 
+					val = data.maxCoeff() - data.mean();
+				else if (stat == "minmean") 
+					val = data.minCoeff() - data.mean();
+				else if (stat == "std" || stat == "stddev") 
+					val = sqrt((data.array() - data.mean()).square().sum() / (data.size() - 1));
+				else if (stat == "amplitude") {
+					bool onlyFFT = true;
+					double r2Max = 0.95;
+					double T, H;
+					GetWaveRegularAmplitude(fast, T, H);
+					val = GetRAO(data, time, T, onlyFFT, r2Max);
+				} else if (stat == "rao") {
+					bool onlyFFT = true;
+					double r2Max = 0.95;
+					double T, H;
+					GetWaveRegularAmplitude(fast, T, H);
+					val = GetRAO(data, time, T, onlyFFT, r2Max);
+					val /= H;
+				} else if (stat == "rao_mean") 
+					val = data.tail(data.size()/2).mean();	// mean of the half end
 				else if (stat == "percentile") {
 					if (pars.size() == 2) {
-						double percent = ScanDouble(pars[1]);
-						if (IsNull(percent) || percent < 0 || percent > 1)
-							throw Exc(F("percentile(%s) argument is not correct", pars[1]));	
 						EigenVector v(data, 0, 1);
-						val = v.PercentileValY(percent);	
+						val = v.PercentileValY(ScanDouble(pars[1]));	
 					} else if (pars.size() == 3) {
-						double percentMin = ScanDouble(pars[1]);
-						double percentMax = ScanDouble(pars[2]);
-						if (IsNull(percentMin) || percentMin < 0 || percentMin > 1 ||
-							IsNull(percentMax) || percentMax < 0 || percentMax > 1)
-							throw Exc(F("percentile(%s, %s) arguments are not correct", pars[1], pars[2]));	
 						EigenVector v(data, 0, 1);
-						val = v.PercentileValRangeY(percentMin, percentMax);	
+						val = v.PercentileValRangeY(ScanDouble(pars[1]), ScanDouble(pars[2]));	
 					} else
 						throw Exc("'percentile' requires one or two arguments");
 				} else if (stat == "weibull") {
 					if (pars.size() != 2)
 						throw Exc("'weibull' requires one argument");
-					VectorXd d = Map<VectorXd>(fullData[ip], fullData[ip].size());
-					EigenVector v(d, 0, 1);
-					val = v.PercentileWeibullValY(ScanDouble(pars[1]));				
+					EigenVector v(data, 0, 1);
+					val = v.PercentileWeibullValY(ScanDouble(pars[1]));
 				} else if (stat == "td") {
 					if (pars.size() != 4)
 						throw Exc("'td' requires three arguments");
@@ -1349,40 +2011,303 @@ void Calc(const UArray<FastOut> &dataFast, const ParameterMetrics &params0, Para
 					double gamma_mean = ScanDouble(pars[2]);
 					double gamma_dyn = ScanDouble(pars[3]);
 					
-					VectorXd d = Map<VectorXd>(fullData[ip], fullData[ip].size());
 					UVector<double> maxs;
 					int id0 = 0;
-					double t0 = fullTime[0];
-					for (int i = 0; i < fullTime.size(); ++i) {
-						if (fullTime[i] - t0 >= deltaTime) {
-							maxs << d.segment(id0, i - id0 + 1).maxCoeff();
+					double t0 = time[0];
+					for (int i = 0; i < time.size(); ++i) {
+						if (time[i] - t0 >= deltaTime) {
+							maxs << data.segment(id0, i - id0 + 1).maxCoeff();
 							id0 = i+1;
-							t0 = fullTime[id0];
+							t0 = time[id0];
 						}
 					}
-					if (Last(fullTime) - t0 >= 0.75*deltaTime)
-						maxs << d.segment(id0, fullTime.size() - id0).maxCoeff();
+					if (Last(time) - t0 >= deltaTime*0.75)
+						maxs << data.segment(id0, data.size() - id0).maxCoeff();
 					if (maxs.size() > 1) {
-						double mean = d.mean();
+						double mean = data.mean();
 						double mpm = Avg(maxs) - 0.45*StdDev(maxs, mean);
 						double tc_dyn = mpm - mean;
-						val = mean*gamma_mean + tc_dyn*gamma_dyn; 		// From DNV-OS-E301				
+						val = mean*gamma_mean + tc_dyn*gamma_dyn; 		// From DNV-OS-E301
 					}
-				} else if (stat == "demo") 
-					;
-				else
+				} else if (stat == "del") {
+					if (pars.size() != 2 && pars.size() != 3)
+						throw Exc("'del' requires one or two arguments");
+					double neq;
+					if (pars.size() == 3)
+						neq = ScanDouble(pars[2]);
+					else
+						neq = Last(time) - time[0];		// 1 Hz equivalent cycles
+					val = GetDEL(data, ScanDouble(pars[1]), neq);
+				} else if (stat == "demo") {
+					if (pars.size() != 3)
+						throw Exc("'demo' requires two arguments");
+					val = ScanDouble(pars[1]) + ScanDouble(pars[2]);
+				} else
 					throw Exc(F(t_("Unknown '%s' statistic in parameter '%s'"), stat, param.name));
 				
 				t << val;//F("%" + format, val);
 			}
 		}
 	}
-	for (int row = 0; row < table.size() - (table.size() > 1 ? 1 : 0); ++row) {
-		table[row][1] = SecondsToString(double(table[row][1]), 0, false, false, true, false, true);
-		table[row][2] = SecondsToString(double(table[row][2]), 0, false, false, true, false, true);
+}
+
+// Adds the Total row. If fullTime is empty, the metrics that need the full series are Null
+static void CalcTotal(const ParameterMetrics &params, UVector<UVector<Value>> &table, 
+					const UVector<UVector<double>> &fullData, const UVector<double> &fullTime) {
+	UVector<Value> &t = table.Add();
+	t << t_("Total");
+	t << t_("-");
+	t << t_("-");
+	VectorXd data(table.size()-1), time(table.size()-1);
+	int col = 3;
+	for (int ip = 0; ip < params.params.size(); ip++) {
+		const ParameterMetric &param = params.params[ip];
+	
+		for (int i = 0; i < param.metrics.size(); i++) {
+			for (int row = 0; row < table.size()-1; ++row) {
+				data[row] = double(table[row][col]);
+				time[row] = double(table[row][2]) - double(table[row][1]);
+			}
+			col++;
+			String str = param.metrics[i];
+			str.Replace("(", ",");
+			str.Replace(")", ",");
+			UVector<String> pars = Split(str, ",");
+			Trim(pars);
+			if (pars.IsEmpty())
+				continue;
+			String stat = pars[0];
+				
+			double val = Null;
+			if (fullTime.IsEmpty() && (stat == "std" || stat == "stddev" || stat == "weibull" || stat == "td"))
+				;		// The full series are not kept when the files are streamed
+			else if (stat == "mean" || stat == "avg") 
+				val = (data.array()*time.array()).sum() / time.sum();
+			else if (stat == "min") 
+				val = data.minCoeff();
+			else if (stat == "max") 
+				val = data.maxCoeff();
+			else if (stat == "rangeminmax") 
+				val = data.maxCoeff() - data.minCoeff();
+			else if (stat == "maxval") { 
+				double mx = data.maxCoeff();
+				double mn = data.minCoeff();
+				if (abs(mx) > abs(mn))
+					val = mx;
+				else
+					val = mn;
+			} else if (stat == "maxmean") {
+				double mean = (data.array()*time.array()).sum() / time.sum();
+				val = data.maxCoeff() - mean;
+			} else if (stat == "minmean") { 
+				double mean = (data.array()*time.array()).sum() / time.sum();
+				val = data.minCoeff() - mean;
+			} else if (stat == "std" || stat == "stddev") {
+				VectorXd d = Map<VectorXd>(fullData[ip], fullData[ip].size());	
+				val = sqrt((d.array() - d.mean()).square().sum() / (d.size() - 1));
+			} else if (stat == "amplitude") 
+				val = Null;
+			else if (stat == "rao") 
+				val = Null;
+			else if (stat == "rao_mean") 
+				val = Null;
+			else if (stat == "percentile") {
+				if (pars.size() == 2) {
+					double percent = ScanDouble(pars[1]);
+					if (IsNull(percent) || percent < 0 || percent > 1)
+						throw Exc(F("percentile(%s) argument is not correct", pars[1]));	
+					EigenVector v(data, 0, 1);
+					val = v.PercentileValY(percent);	
+				} else if (pars.size() == 3) {
+					double percentMin = ScanDouble(pars[1]);
+					double percentMax = ScanDouble(pars[2]);
+					if (IsNull(percentMin) || percentMin < 0 || percentMin > 1 ||
+						IsNull(percentMax) || percentMax < 0 || percentMax > 1)
+						throw Exc(F("percentile(%s, %s) arguments are not correct", pars[1], pars[2]));	
+					EigenVector v(data, 0, 1);
+					val = v.PercentileValRangeY(percentMin, percentMax);	
+				} else
+					throw Exc("'percentile' requires one or two arguments");
+			} else if (stat == "weibull") {
+				if (pars.size() != 2)
+					throw Exc("'weibull' requires one argument");
+				VectorXd d = Map<VectorXd>(fullData[ip], fullData[ip].size());
+				EigenVector v(d, 0, 1);
+				val = v.PercentileWeibullValY(ScanDouble(pars[1]));				
+			} else if (stat == "del") {
+				if (pars.size() != 2 && pars.size() != 3)
+					throw Exc("'del' requires one or two arguments");
+				double m = ScanDouble(pars[1]);
+				if (IsNull(m) || m <= 0)
+					throw Exc(F("del(%s) argument is not correct", pars[1]));
+				// The damage of every file is DEL^m*neq, so the 1 Hz DELs are weighted by their duration
+				if (pars.size() == 3)
+					val = pow(data.array().pow(m).sum(), 1/m);
+				else
+					val = pow((data.array().pow(m)*time.array()).sum() / time.sum(), 1/m);
+			} else if (stat == "td") {
+				if (pars.size() != 4)
+					throw Exc("'td' requires three arguments");
+				double deltaTime = StringToSeconds(pars[1]);
+				double gamma_mean = ScanDouble(pars[2]);
+				double gamma_dyn = ScanDouble(pars[3]);
+				
+				VectorXd d = Map<VectorXd>(fullData[ip], fullData[ip].size());
+				UVector<double> maxs;
+				int id0 = 0;
+				double t0 = fullTime[0];
+				for (int i = 0; i < fullTime.size(); ++i) {
+					if (fullTime[i] - t0 >= deltaTime) {
+						maxs << d.segment(id0, i - id0 + 1).maxCoeff();
+						id0 = i+1;
+						t0 = fullTime[id0];
+					}
+				}
+				if (Last(fullTime) - t0 >= 0.75*deltaTime)
+					maxs << d.segment(id0, fullTime.size() - id0).maxCoeff();
+				if (maxs.size() > 1) {
+					double mean = d.mean();
+					double mpm = Avg(maxs) - 0.45*StdDev(maxs, mean);
+					double tc_dyn = mpm - mean;
+					val = mean*gamma_mean + tc_dyn*gamma_dyn; 		// From DNV-OS-E301				
+				}
+			} else if (stat == "demo") 
+				;
+			else
+				throw Exc(F(t_("Unknown '%s' statistic in parameter '%s'"), stat, param.name));
+			
+			t << val;//F("%" + format, val);
+		}
 	}
 }
 
+static void FormatRowTimes(UVector<Value> &row) {
+	row[1] = SecondsToString(double(row[1]), 0, false, false, true, false, true);
+	row[2] = SecondsToString(double(row[2]), 0, false, false, true, false, true);
+}
+
+void Calc(const UArray<FastOut> &dataFast, const ParameterMetrics &params0, ParameterMetrics &params, double start, double end, UVector<UVector<Value>> &table, Function <bool(String, int)> Status) {
+	table.Clear();
+	
+	for (const FastOut &fast : dataFast) 
+		CalcParams(fast, params0, params);
+	
+	// Does the real job
+	UVector<UVector<double>> fullData(params.params.size());
+	UVector<double> fullTime;
+	for (int i = 0; i < dataFast.size(); ++i) {
+		if (Status && !Status(t_("Calculating"), int(100*(i+1.)/dataFast.size())))
+			throw Exc(t_("Stop by user"));
+		CalcRow(dataFast[i], params, start, end, table.Add(), &fullData, &fullTime);
+	}
+	if (dataFast.size() > 1) 
+		CalcTotal(params, table, fullData, fullTime);
+	for (int row = 0; row < table.size() - (table.size() > 1 ? 1 : 0); ++row) 
+		FormatRowTimes(table[row]);
+}
+
+String CalcStream(const UVector<String> &files, const ParameterMetrics &params0, ParameterMetrics &params, double start, double end, 
+				Function <void(const UVector<Value> &)> WhenRow, int numThreads, Function <bool(String, int)> Status) {
+	try {
+		int num = files.size();
+		if (num == 0)
+			throw Exc(t_("No files to process"));
+		if (IsNull(numThreads))
+			numThreads = CPU_Cores();
+		numThreads = minmax(numThreads, 1, num);
+		
+		// The rows are kept, without the series, for the Total row
+		UVector<UVector<Value>> table(num);
+		UVector<bool> ready(num, false);
+		
+		auto CalcFile = [&](int i, bool first) {
+			FastOut fast;
+			fast.derived = true;
+			String error = fast.Load(files[i]);
+			if (!error.IsEmpty())
+				throw Exc(F(t_("Problem loading '%s': %s"), files[i], error));
+			if (first)
+				CalcParams(fast, params0, params);
+			UVector<Value> row;
+			CalcRow(fast, params, start, end, row, nullptr, nullptr);
+			return row;
+		};
+		table[0] = CalcFile(0, true);		// The parameters are taken from the first file
+		ready[0] = true;
+		
+		std::atomic<int> next(1), running(numThreads);
+		std::atomic<bool> cancel(false);
+		Mutex mutex;
+		String error;
+		UArray<Thread> threads;
+		for (int it = 0; it < numThreads; ++it) 
+			threads.Add().Run([&] {
+				try {
+					while (!cancel) {
+						int i = next++;
+						if (i >= num)
+							break;
+						UVector<Value> row = CalcFile(i, false);
+						Mutex::Lock __(mutex);
+						table[i] = pick(row);
+						ready[i] = true;
+					}
+				} catch (Exc e) {
+					Mutex::Lock __(mutex);
+					if (error.IsEmpty())
+						error = e;
+					cancel = true;
+				}
+				running--;
+			});
+		
+		int numDone = 0;
+		auto Flush = [&] {			// The rows are passed in file order
+			while (true) {
+				UVector<Value> row;
+				{
+					Mutex::Lock __(mutex);
+					if (numDone >= num || !ready[numDone])
+						return;
+					row = clone(table[numDone]);
+				}
+				FormatRowTimes(row);
+				WhenRow(row);
+				numDone++;
+			}
+		};
+		while (running > 0) {
+			try {
+				Flush();
+				if (Status && !Status(F(t_("Calculating %d/%d"), numDone, num), 100*numDone/num))
+					cancel = true;
+			} catch (Exc e) {		// The threads have to finish before leaving
+				Mutex::Lock __(mutex);
+				if (error.IsEmpty())
+					error = e;
+				cancel = true;
+			}
+			Sleep(50);
+		}
+		for (Thread &t : threads)
+			t.Wait();
+		
+		if (!error.IsEmpty())
+			throw Exc(error);
+		if (cancel)
+			throw Exc(t_("Cancelled by the user"));
+		Flush();
+		
+		if (num > 1) {
+			CalcTotal(params, table, UVector<UVector<double>>(), UVector<double>());
+			WhenRow(table.Top());
+		}
+	} catch (Exc e) {
+		return e;
+	}
+	return String();
+}
+
 void FASTCase::CreateFolderCase(String folder) {
 	Time t = GetSysTime();
 	
@@ -1490,9 +2415,12 @@ double GetDecayPeriod(FastOut &fst, BasicBEM::DOF dof, double &r2, double &damp)
 	if (id < 0) 
 		throw Exc(F("Param. %s not found in %s", param, fst.GetFileName()));
 
+	UVector<UVector<double>> data(2);
+	fst.GetChannel(0, data[0]);
+	fst.GetChannel(id, data[1]);
 	UVector<int> idsx, idsy, idsFixed;
 	VectorVectorY<double> vect;
-	vect.Init(fst.dataOut, 0, id, idsx, idsy, idsFixed, false);
+	vect.Init(data, 0, 1, idsx, idsy, idsFixed, false);
 	
 	DampedSinEquation eq;
 	ExplicitEquation::FitError err = eq.Fit(vect, r2);
@@ -1540,9 +2468,12 @@ void GetWaveRegularAmplitude(const FastOut &dataFast, double &T, double &H) {
 	if (id < 0) 
 		throw Exc(F("Param. %s not found", param));
 
+	UVector<UVector<double>> data(2);
+	dataFast.GetChannel(0, data[0]);
+	dataFast.GetChannel(id, data[1]);
 	UVector<int> idsx, idsy, idsFixed;
 	VectorVectorY<double> vect;
-	vect.Init(dataFast.dataOut, 0, id, idsx, idsy, idsFixed, false);
+	vect.Init(data, 0, 1, idsx, idsy, idsFixed, false);
 
 	SinEquation eq;
 	double r2;
@@ -1612,3 +2543,66 @@ bool FastOut::CalcTipPos(int idBlade, int idtime, double tipdx, double tipdy, do
 	
 	return true;	
 }
+
+void FastOut::CalcTipBlock(int idBlade, int idTipdx, int idTipdy, int idx, int idy, int idz, int idt0, int idt1) {
+	for (int idt = idt0; idt < idt1; ++idt) {
+		double tipdx = 0, tipdy = 0;
+		if (!IsNull(idTipdx) && !IsNull(idTipdy)) {
+			tipdx = Nvl(GetVal(idt, idTipdx), 0.);
+			tipdy = Nvl(GetVal(idt, idTipdy), 0.);
+		}
+		double Tx, Ty, Tz;
+		if (!CalcTipPos(idBlade, idt, tipdx, tipdy, Tx, Ty, Tz))
+			Tx = Ty = Tz = Null;
+		dataOut[idx][idt] = Tx;
+		if (idy >= 0)			// y and z may be disabled
+			dataOut[idy][idt] = Ty;
+		if (idz >= 0)
+			dataOut[idz][idt] = Tz;
+	}
+}
+
+void FastOut::CalcParam::CalcNorm(int idt0, int idt1, int idx, int idy, int idz, bool checkNull) {
+	const double *x = dF->dataOut[idx], *y = dF->dataOut[idy];
+	const double *z = idz >= 0 ? (const double *)dF->dataOut[idz] : nullptr;
+	double *data = dF->dataOut[id];
+	for (int idt = idt0; idt < idt1; ++idt) {
+		if (checkNull && (IsNull(x[idt]) || IsNull(y[idt]) || (z && IsNull(z[idt]))))
+			data[idt] = Null;
+		else if (z)
+			data[idt] = sqrt(x[idt]*x[idt] + y[idt]*y[idt] + z[idt]*z[idt]);
+		else
+			data[idt] = sqrt(x[idt]*x[idt] + y[idt]*y[idt]);
+	}
+}
+
+String FastOut::BenchmarkDerived(int &num) {
+	int numData = GetNumData();
+	
+	TimeStop t;
+	CalcDerived(false);
+	double tSample = t.Seconds();
+	num = GetDerivedCount();
+	UVector<UVector<double>> sample(num);
+	for (int i = 0; i < num; ++i)
+		GetChannel(numRaw + i, sample[i]);
+	
+	t.Reset();
+	CalcDerived(true);
+	double tBlock = t.Seconds();
+	
+	if (GetDerivedCount() != num)
+		throw Exc(t_("The number of derived channels is different"));
+	for (int i = 0; i < num; ++i) {
+		const UVector<double> &a = sample[i];
+		for (int idt = 0; idt < numData; ++idt) {
+			double b = GetVal(idt, numRaw + i);
+			if (a[idt] != b && !(std::isnan(a[idt]) && std::isnan(b)))
+				throw Exc(F(t_("Derived channel '%s' is different in time %f"), parameters[numRaw + i], GetVal(idt, 0)));
+		}
+	}
+	String ret = F(t_("%d derived channels of %d samples"), num, numData);
+	ret << "\n" << F(t_("Sample by sample: %.3f s"), tSample);
+	ret << "\n" << F(t_("Column blocks:    %.3f s (x%.1f)"), tBlock, tSample/max(tBlock, 1E-9));
+	return ret;
+}
@@ -5,6 +5,23 @@
 
 
 //bool FindHydrodynCB(String path, double &ptfmCOBxt, double &ptfmCOByt);
+
+// Min/max pyramid of a series, to plot it at screen resolution without losing the peaks
+class MinMaxPyramid {
+public:
+	void Build(const UVector<double> &y);
+	void Clear()				{imin.Clear(); imax.Clear(); count = 0;}
+	int GetCount() const		{return count;}
+	
+	// Ids of the points to plot from id0 to id1 in about num columns: the min and max of each column, in order.
+	// The cost depends on num, not on id1 - id0
+	void Get(int id0, int id1, int num, UVector<int> &ids) const;
+	
+private:
+	enum {BASE = 16};						// Samples in the blocks of the first level
+	UVector<UVector<int>> imin, imax;		// Blocks of level l have BASE << l samples
+	int count = 0;
+};
 	
 class FastOut {
 public:
@@ -14,8 +31,26 @@ public:
 	static UVector<String> GetFilesToLoad(String path);
 	static String GetFileToLoad(String fileName);
 	
-	String Load(String fileName, Function <bool(String, int)> Status = Null);
+	// If params is not empty, only the time and the matching channels are loaded. '*' allowed
+	String Load(String fileName, Function <bool(String, int)> Status = Null, const UVector<String> &params = UVector<String>());
+	
+	bool sidecar = false;						// If true, Load() reads the binary copy of the data next to the file, or saves it after parsing
+	static String GetSidecarName(String fileName)	{return fileName + ".bmrts";}
+	static String BenchmarkSidecar(String fileName, int &num);
+	
+	bool derived = true;						// If true, Load() also adds the derived channels. Disable it to load only the channels in the file
+	void CalcDerived(bool block = true);		// Adds or updates the derived channels, by column blocks in parallel or sample by sample
+	int GetDerivedCount() const					{return IsNull(numRaw) ? 0 : parameters.size() - numRaw;}
+	String BenchmarkDerived(int &num);
+	
+	bool single = false;						// If true, Load() keeps the channels, except time, in single precision
+	void PackSingle();							// Converts the channels, except time, to single precision
+	void UnpackSingle();						// Converts the channels back to double precision
+	int64 GetMemory() const;					// Bytes used by the channel data
+	static String BenchmarkSingle(String fileName, int &num);
+	
 	bool Save(String fileName, Function <bool(String, int)> Status, String type = "", String sep = "", const UVector<int> &ids = UVector<int>());
+	String BenchmarkSave(String folder, int &num);
 	
 	void AppendLine(int numLine, FastOut &fst);
 	
@@ -35,9 +70,16 @@ public:
 	SortedVectorMap<String, String> GetList(String filterParam = "", String filterUnits = "");
 		
 	double GetVal(double time, int idparam) const;
-	inline double GetVal(int idtime, int idparam) const	  		{return dataOut[idparam][idtime];}
-	inline const UVector<double> &GetUVector(int idparam) const {return dataOut[idparam];}
-	inline const UVector<double> &GetUVector(String param) const {
+	inline double GetVal(int idtime, int idparam) const {
+		return IsSingle(idparam) ? ToDouble(dataSingle[idparam][idtime]) : dataOut[idparam][idtime];
+	}
+	// If the channel is in single precision, it is converted back to double
+	inline const UVector<double> &GetUVector(int idparam) {
+		if (IsSingle(idparam))
+			UnpackSingle(idparam);
+		return dataOut[idparam];
+	}
+	inline const UVector<double> &GetUVector(String param) {
 		static UVector<double> bad;
 		UVector<int> ids = FindParameterMatch(param);
 		if (ids.IsEmpty())
@@ -45,15 +87,13 @@ public:
 		else
 			return GetUVector(ids[0]);
 	}
-	VectorXd GetVector(int idparam) const {
-		const UVector<double> &d = GetUVector(idparam);
-		VectorXd ret = Map<const VectorXd>(d, d.size());
-		return ret;
-	}
+	void GetChannel(int idparam, UVector<double> &data) const;		// Copy in double precision
+	VectorXd GetVector(int idparam) const;
 	VectorXd GetVector(String param) const {
-		const UVector<double> &d = GetUVector(param);
-		VectorXd ret = Map<const VectorXd>(d, d.size());
-		return ret;
+		UVector<int> ids = FindParameterMatch(param);
+		if (ids.IsEmpty())
+			return VectorXd();
+		return GetVector(ids[0]);
 	}
 	
 	void SetVal(int idparam, double val);
@@ -63,6 +103,7 @@ public:
 	double GetTimeStart() const;
 	double GetTimeEnd()	 const;
 	int GetNumData() const;
+	int GetNumData(int idparam) const	{return IsSingle(idparam) ? dataSingle[idparam].size() : dataOut[idparam].size();}
 	bool IsEmpty() const		{return dataOut.IsEmpty();}	
 	
 	String GetFileName() const	{return fileName;}
@@ -78,8 +119,14 @@ public:
 	}
 	
 	void Serialize(Stream& s) {
+        bool packed = s.IsStoring() && !dataSingle.IsEmpty();
+        if (packed)
+            UnpackSingle();
         s % dataOut % parameters % units;
+        if (packed)
+            PackSingle();
         if (s.IsLoading()) {
+            dataSingle.Clear();
             parametersd.Clear();
 			for (int i = 0; i < parameters.size(); ++i)
 				parametersd << ToLower(parameters[i]);
@@ -93,6 +140,11 @@ public:
 		CalcParam *Init0(FastOut *_dataFast) {dF = _dataFast; return this;}
 		virtual void Init() = 0;
 		virtual double Calc(int idt) = 0;
+		virtual void CalcBlock(int idt0, int idt1) {		// Fills the column from idt0 to idt1 - 1
+			UVector<double> &data = dF->dataOut[id];
+			for (int idt = idt0; idt < idt1; ++idt)
+				data[idt] = Calc(idt);
+		}
 		bool IsEnabled()	{return enabled;}
 		String name, units;
 		int id = -1;
@@ -100,6 +152,8 @@ public:
 	protected:
 		FastOut *dF = nullptr;
 		bool enabled = true;
+		
+		void CalcNorm(int idt0, int idt1, int idx, int idy, int idz, bool checkNull);
 	};
 	
 	int AddParam(String name, String unit) {
@@ -112,6 +166,8 @@ public:
 	}
 	
 	int GetParamCount() {return parameters.size();}
+	
+	const MinMaxPyramid &GetPyramid(int idparam);	// Built when first asked, and again if the data has changed
  
 	UVector<String> parameters, units, descriptions;
 	UVector<String> parametersd, unitsd;
@@ -171,16 +227,34 @@ private:
 	bool SaveOut(String fileName, Function <bool(String, int)> Status, const UVector<int> &ids);
 	String LoadCsv(String fileName, Function <bool(String, int)> Status);
 	bool SaveCsv(String fileName, Function <bool(String, int)> Status, String sep, const UVector<int> &ids);
+	bool SaveOutb(String fileName, Function <bool(String, int)> Status, const UVector<int> &ids);
+	void GetSaveIds(const UVector<int> &ids, UVector<int> &cols) const;
+	void SaveRows(Stream &data, const UVector<int> &cols, String sep, int numDigits, String fileName, Function <bool(String, int)> Status) const;
 	String LoadDb(String fileName, Function <bool(String, int)> Status);
 	String Load_LIS(String fileName);
 	void AfterLoad();
+	
+	static String GetSidecarKey(String fileName);
+	bool LoadSidecar(String fileName, const UVector<String> &params);
+	void SaveSidecar(String fileName) const;
+	void SelectParameters(const UVector<String> &params);
 
 	String fileName;
 	
 	int idActualTime = -1;
+	int numRaw = Null;					// Parameters in the file, before the derived ones
 	
 	VectorMap<String, String> syn;		// Synonyms
 	
+	UArray<MinMaxPyramid> pyramids;
+	
+	UVector<UVector<float>> dataSingle;	// Channels in single precision. Their dataOut is empty. Null is stored as NaN
+	bool IsSingle(int idparam) const	{return idparam < dataSingle.size() && !dataSingle[idparam].IsEmpty();}
+	void UnpackSingle(int idparam);
+	void BuildPyramid(int idparam);
+	static float ToSingle(double v)		{return IsNull(v) ? std::numeric_limits<float>::quiet_NaN() : float(v);}
+	static double ToDouble(float v)		{return std::isnan(v) ? double(Null) : double(v);}
+	
 	struct TiltParam : CalcParam {
 		TiltParam() {
 			name = "PtfmTilt";
@@ -198,6 +272,7 @@ private:
 							
 			return sqrt(roll*roll + pitch*pitch);
 		}	
+		virtual void CalcBlock(int idt0, int idt1) {CalcNorm(idt0, idt1, dF->idroll, dF->idpitch, -1, true);}
 	} ptfmtilt; 
 
 	struct ShiftParam : CalcParam {
@@ -217,9 +292,11 @@ private:
 			
 			return sqrt(surge*surge + sway*sway);
 		}	
+		virtual void CalcBlock(int idt0, int idt1) {CalcNorm(idt0, idt1, dF->idsurge, dF->idsway, -1, true);}
 	} ptfmshift; 
 
 	bool CalcTipPos(int idBlade, int idtime, double tipdx, double tipdy, double &Tx, double &Ty, double &Tz);
+	void CalcTipBlock(int idBlade, int idTipdx, int idTipdy, int idx, int idy, int idz, int idt0, int idt1);
 	
 	struct BladeTip1xParam : CalcParam {
 		BladeTip1xParam() {
@@ -239,6 +316,9 @@ private:
 			
 			return Tx;
 		}	
+		virtual void CalcBlock(int idt0, int idt1) {		// Fills also y and z
+			dF->CalcTipBlock(0, idTipdx, idTipdy, id, dF->bladeTip1yParam.id, dF->bladeTip1zParam.id, idt0, idt1);
+		}
 		double Tx, Ty, Tz;
 		int idTipdx = Null, idTipdy = Null;
 		bool isnull;
@@ -257,6 +337,7 @@ private:
 			
 			return dF->bladeTip1xParam.Ty;
 		}	
+		virtual void CalcBlock(int, int) {}				// Filled by the x param
 	} bladeTip1yParam; 
 
 
@@ -273,6 +354,7 @@ private:
 			
 			return dF->bladeTip1xParam.Tz;
 		}	
+		virtual void CalcBlock(int, int) {}				// Filled by the x param
 	} bladeTip1zParam; 
 
 	struct BladeTip2xParam : CalcParam {
@@ -293,6 +375,9 @@ private:
 			
 			return Tx;
 		}	
+		virtual void CalcBlock(int idt0, int idt1) {		// Fills also y and z
+			dF->CalcTipBlock(1, idTipdx, idTipdy, id, dF->bladeTip2yParam.id, dF->bladeTip2zParam.id, idt0, idt1);
+		}
 		double Tx, Ty, Tz;
 		int idTipdx = Null, idTipdy = Null;
 		bool isnull;
@@ -311,6 +396,7 @@ private:
 			
 			return dF->bladeTip2xParam.Ty;
 		}	
+		virtual void CalcBlock(int, int) {}				// Filled by the x param
 	} bladeTip2yParam; 
 
 
@@ -327,6 +413,7 @@ private:
 			
 			return dF->bladeTip2xParam.Tz;
 		}	
+		virtual void CalcBlock(int, int) {}				// Filled by the x param
 	} bladeTip2zParam; 
 	
 	struct BladeTip3xParam : CalcParam {
@@ -347,6 +434,9 @@ private:
 			
 			return Tx;
 		}	
+		virtual void CalcBlock(int idt0, int idt1) {		// Fills also y and z
+			dF->CalcTipBlock(2, idTipdx, idTipdy, id, dF->bladeTip3yParam.id, dF->bladeTip3zParam.id, idt0, idt1);
+		}
 		double Tx, Ty, Tz;
 		int idTipdx = Null, idTipdy = Null;
 		bool isnull;
@@ -365,6 +455,7 @@ private:
 			
 			return dF->bladeTip3xParam.Ty;
 		}	
+		virtual void CalcBlock(int, int) {}				// Filled by the x param
 	} bladeTip3yParam; 
 
 
@@ -381,6 +472,7 @@ private:
 			
 			return dF->bladeTip3xParam.Tz;
 		}	
+		virtual void CalcBlock(int, int) {}				// Filled by the x param
 	} bladeTip3zParam; 	
 				
 	struct TwrBsShearParam : CalcParam {
@@ -402,6 +494,7 @@ private:
 			
 			return sqrt(fx*fx + fy*fy);
 		}	
+		virtual void CalcBlock(int idt0, int idt1) {CalcNorm(idt0, idt1, idx, idy, -1, true);}
 		int idx = Null, idy = Null;	
 	} twrBsShear;
 	
@@ -424,6 +517,7 @@ private:
 							
 			return sqrt(mx*mx + my*my);
 		}	
+		virtual void CalcBlock(int idt0, int idt1) {CalcNorm(idt0, idt1, idx, idy, -1, true);}
 		int idx = Null, idy = Null;	
 	} twrBsBend;	
 
@@ -446,6 +540,7 @@ private:
 						
 			return sqrt(fx*fx + fy*fy);
 		}	
+		virtual void CalcBlock(int idt0, int idt1) {CalcNorm(idt0, idt1, idx, idy, -1, true);}
 		int idx = Null, idy = Null;	
 	} yawBrShear;
 
@@ -468,6 +563,7 @@ private:
 						
 			return sqrt(mx*mx + my*my);
 		}	
+		virtual void CalcBlock(int idt0, int idt1) {CalcNorm(idt0, idt1, idx, idy, -1, true);}
 		int idx = Null, idy = Null;	
 	} yawBrBend;
 
@@ -487,6 +583,7 @@ private:
 			
 			return sqrt(fx*fx + fy*fy);
 		}	
+		virtual void CalcBlock(int idt0, int idt1) {CalcNorm(idt0, idt1, idx, idy, -1, false);}
 		int idx = Null, idy = Null;	
 	} rootShear1;
 
@@ -506,6 +603,7 @@ private:
 			
 			return sqrt(mx*mx + my*my);
 		}	
+		virtual void CalcBlock(int idt0, int idt1) {CalcNorm(idt0, idt1, idx, idy, -1, false);}
 		int idx = Null, idy = Null;	
 	} rootBend1;
 
@@ -525,6 +623,7 @@ private:
 			
 			return sqrt(fx*fx + fy*fy);
 		}	
+		virtual void CalcBlock(int idt0, int idt1) {CalcNorm(idt0, idt1, idx, idy, -1, false);}
 		int idx = Null, idy = Null;	
 	} rootShear2;
 
@@ -544,6 +643,7 @@ private:
 			
 			return sqrt(mx*mx + my*my);
 		}	
+		virtual void CalcBlock(int idt0, int idt1) {CalcNorm(idt0, idt1, idx, idy, -1, false);}
 		int idx = Null, idy = Null;	
 	} rootBend2;
 	
@@ -563,6 +663,7 @@ private:
 			
 			return sqrt(fx*fx + fy*fy);
 		}	
+		virtual void CalcBlock(int idt0, int idt1) {CalcNorm(idt0, idt1, idx, idy, -1, false);}
 		int idx = Null, idy = Null;	
 	} rootShear3;
 
@@ -582,6 +683,7 @@ private:
 			
 			return sqrt(mx*mx + my*my);
 		}	
+		virtual void CalcBlock(int idt0, int idt1) {CalcNorm(idt0, idt1, idx, idy, -1, false);}
 		int idx = Null, idy = Null;	
 	} rootBend3;
 	
@@ -603,6 +705,7 @@ private:
 			
 			return sqrt(ax*ax + ay*ay + az*az);
 		}	
+		virtual void CalcBlock(int idt0, int idt1) {CalcNorm(idt0, idt1, idx, idy, idz, false);}
 		int idx = Null, idy = Null, idz = Null;	
 	} ncIMUTA;
 	
@@ -628,6 +731,12 @@ private:
 							
 			return fairTen/1000/9.8;
 		}	
+		virtual void CalcBlock(int idt0, int idt1) {
+			const double *fairTen = dF->dataOut[idFair];
+			double *data = dF->dataOut[CalcParam::id];
+			for (int idt = idt0; idt < idt1; ++idt)
+				data[idt] = IsNull(fairTen[idt]) ? Null : fairTen[idt]/1000/9.8;
+		}
 		int id, idFair;
 	};
 	UArray<Fairten_tParam> fairTens;	
@@ -656,6 +765,7 @@ private:
 							
 			return sqrt(fx*fx + fy*fy);
 		}	
+		virtual void CalcBlock(int idt0, int idt1) {CalcNorm(idt0, idt1, idx, idy, -1, true);}
 		int id, idx, idy;
 	};
 	UArray<AnchTenHor> anchTens;
@@ -677,6 +787,12 @@ private:
 		virtual double Calc(int idtime) {
 			return dF->GetVal(idtime, idz);
 		}	
+		virtual void CalcBlock(int idt0, int idt1) {
+			const double *z = dF->dataOut[idz];
+			double *data = dF->dataOut[CalcParam::id];
+			for (int idt = idt0; idt < idt1; ++idt)
+				data[idt] = z[idt];
+		}
 		int id, idz;
 	};
 	UArray<AnchTenV> anchTensV;
@@ -686,6 +802,27 @@ private:
 };
 
 
+// Scatter data source of a FastOut parameter between idBegin and idBegin + num - 1.
+// SetView() decimates it to the visible x range
+class FastOutSource : public DataSource {
+public:
+	void Init(FastOut &fast, int col, int idBegin, int num, double xfactor);
+	void SetView(double xmin, double xmax, int pixels);		// In x units, after xfactor
+	
+	virtual double x(int64 id)			{return time[ids[int(id)]]*xfactor;}
+	virtual double y(int64 id)			{return fast->GetVal(ids[int(id)], col);}
+	virtual int64 GetCount() const		{return ids.size();}
+	
+private:
+	const FastOut *fast = nullptr;
+	int col = 0;
+	const MinMaxPyramid *pyramid = nullptr;
+	const double *time = nullptr;
+	int idBegin = 0, num = 0;
+	double xfactor = 1;
+	UVector<int> ids;
+};
+
 class ParameterMetric : public DeepCopyOption<ParameterMetric> {
 public:
 	ParameterMetric() {}
@@ -718,6 +855,13 @@ struct ParameterMetrics {
 void Calc(const UArray<FastOut> &dataFast, const ParameterMetrics &params, ParameterMetrics &realparams, 
 		double start, double end, UVector<UVector<Value>> &table, Function <bool(String, int)> Status = Null);
 
+// Calc() of files that are not loaded at the same time. They are loaded by numThreads threads, and every one is released 
+// after its row, so the memory depends on numThreads, not on the number of files. The parameters are those of the first file.
+// WhenRow gets the rows in file order as soon as they are ready and, at the end, the Total row without std, weibull and td, 
+// as the full series are not kept
+String CalcStream(const UVector<String> &files, const ParameterMetrics &params, ParameterMetrics &realparams, double start, double end, 
+		Function <void(const UVector<Value> &)> WhenRow, int numThreads = Null, Function <bool(String, int)> Status = Null);
+
 
 class FASTCase {
 public:
@@ -747,16 +891,17 @@ public:
 		}
 		
 		elastodyn.IsAvailable();
+		String text = elastodyn.GetText();
 		int pos;
-		String nums = GetFASTVarPos(elastodyn.fileText, "NumTrack", "", pos);
+		String nums = GetFASTVarPos(text, "NumTrack", "", pos);
 		if (pos >= 0) {
 			int num = ScanInt(nums);
-			pos = elastodyn.fileText.FindAfter("\n", pos);
-			pos = elastodyn.fileText.FindAfter("\n", pos);
-			pos = elastodyn.fileText.FindAfter("\n", pos);
+			pos = text.FindAfter("\n", pos);
+			pos = text.FindAfter("\n", pos);
+			pos = text.FindAfter("\n", pos);
 			for (int i = 0; i < num; ++i) {
-				int npos = elastodyn.fileText.FindAfter("\n", pos);
-				String str = elastodyn.fileText.Mid(pos, npos-pos);
+				int npos = text.FindAfter("\n", pos);
+				String str = text.Mid(pos, npos-pos);
 				UVector<String> dat = Split(str, " ");
 				if (dat.size() < 4)
 					continue;
@@ -779,6 +924,9 @@ public:
 	void Setup(String seed, String folder = "");
 	void CreateFolderCase(String folder = "");
 	
+	// Compares the time to set the variables of numCases cases with File and with SetFASTVar()
+	static String BenchmarkCases(String file, int numCases, int &numEqual);
+	
 	bool LoadOut() {
 		return out.Load(fstFile, Null) > 0;
 	}
@@ -786,45 +934,55 @@ public:
 	const String &GetFolderCase()	{return folderCase;}
 	
 //private:
-	class File {
+	// OpenFAST input file, kept as lines with an index of the variable positions. 
+	// Gets and sets match GetFASTVar() and SetFASTVar() on the full text, but only the changed line is rebuilt
+	class File : public DeepCopyOption<File> {
 	public:
 		String fileName;
-		String fileText;
 		bool isChanged = false;
 		
+		File() {}
+		File(const File &f, int) : fileName(f.fileName), isChanged(f.isChanged), lines(clone(f.lines)), index(clone(f.index)), 
+			lineIndex(clone(f.lineIndex)), paragraphs(clone(f.paragraphs)) {}
+		
 		void Save() const {
 			if (!isChanged || fileName.IsEmpty())
 				return;
-			if (!SaveFile(fileName, fileText))
+			if (!SaveFile(fileName, GetText()))
 				throw Exc(F(t_("Impossible to save file '%s'"), fileName));
 		}
 		
 		bool IsAvailable() {
-			if (fileText.IsEmpty()) 
-				fileText = LoadFile(fileName);
-			return !fileText.IsEmpty();
+			if (lines.IsEmpty()) 
+				SetText(LoadFile(fileName));
+			return !IsEmpty();
 		}
+		bool IsEmpty() const	{return lines.IsEmpty();}
+		
+		void SetText(const String &text);
+		String GetText() const;
 		
 		String GetString(String var) {
 			if (!IsAvailable()) 
 				throw Exc(F(t_("Impossible to read file '%s'"), fileName));
 			
-			String res;
 			UVector<String> vars = Split(var, "/");
+			Pos p;
 			if (vars.size() == 2)
-				res = GetFASTVarPos(fileText, vars[1], vars[0], pos);
+				p = FindVar(vars[1], vars[0]);
 			else if (vars.size() == 1)		
-				res = GetFASTVarPos(fileText, vars[0], Null, pos);
+				p = FindVar(vars[0], Null);
 			else
 				throw Exc(F(t_("Wrong variable '%s' in GetString"), var));
 			
+			String res;
+			if (p.line >= 0) {
+				res = lines[p.line].Left(p.col);
+				res.Replace("\"", "");
+				res = Trim(res);
+			}
 			if (res == "")
 				throw Exc(F(t_("Unknown variable '%s' in GetString"), var));
-			
-			if (res[0] == '\"')		// Remove quotes
-				res = res.Mid(1);
-			if (res[res.GetCount()-1] == '\"')
-				res = res.Left(res.GetCount()-1);
 			return res;
 		}
 		double GetDouble(String var) {
@@ -855,29 +1013,19 @@ public:
 		double GetMatrixVal(String var, int row, int col) {
 			if (!IsAvailable()) 
 				throw Exc(F(t_("Impossible to read file '%s'"), fileName));
-			return GetFASTMatrixVal(fileText, var, row, col);
+			return GetFASTMatrixVal(GetText(), var, row, col);
 		}
 		Eigen::MatrixXd GetMatrix(String var, int rows, int cols) {
 			if (!IsAvailable()) 
 				throw Exc(F(t_("Impossible to read file '%s'"), fileName));
-			return GetFASTMatrix(fileText, var, rows, cols);
-		}
-		void SetMatrixVal(String var, int row, int col, double val) {
-			if (!IsAvailable()) 
-				throw Exc(F(t_("Impossible to read file '%s'"), fileName));
-			int posIni, posEnd;
-			GetMatrixIds(var, row, col, posIni, posEnd);
-			
-			int delta = posEnd-posIni-1;
-			
-			isChanged = true;
-			fileText = fileText.Left(posIni) + F(" ") + FDS(val, delta, true) + fileText.Mid(posEnd);
+			return GetFASTMatrix(GetText(), var, rows, cols);
 		}
+		void SetMatrixVal(String var, int row, int col, double val);
 		
 		UVector<UVector<String>> GetFASTArray(String var) {
 			if (!IsAvailable()) 
 				throw Exc(F(t_("Impossible to read file '%s'"), fileName));
-			return ::GetFASTArray(fileText, var);
+			return ::GetFASTArray(GetText(), var);
 		}
 		
 		void SetString(String var, String val) {
@@ -893,34 +1041,43 @@ public:
 		void SetBool(String var, bool val) {
 			SetString0(var, val ? "True" : "False");
 		}
-		
-		int pos = 0;
+		void SetValue(String var, String val) {		// Written as it is, without quotes
+			SetString0(var, val);
+		}
 		
 	private:
+		struct Pos : Moveable<Pos> {
+			int line = -1, col = -1;
+			Pos() {}
+			Pos(int _line, int _col) : line(_line), col(_col) {}
+			bool operator<(const Pos &p) const {return line < p.line || (line == p.line && col < p.col);}
+		};
+		UVector<String> lines;							// Text split by '\n'
+		VectorMap<String, UVector<Pos>> index;			// Tokens where GetFASTVarLine() would find a variable, in text order
+		UVector<UVector<int>> lineIndex;				// Ids in index of the tokens in each line
+		VectorMap<String, UVector<Pos>> paragraphs;		// Ends of the paragraph names found, in text order
+		
+		void IndexLine(int il);
+		void UnindexLine(int il);
+		void ChangeLine(int il, const String &line);
+		bool IsVarAt(int il, int col, int len) const;
+		Pos FindVar(const String &var, const String &paragraph, Pos from = Pos(0, 0));
+		Pos FindParagraph(const String &paragraph, Pos from);
+		
 		void SetString0(String var, String val) {
-			if (fileText.IsEmpty()) {
-				fileText = LoadFile(fileName);
-				if (fileText.IsEmpty())
-					throw Exc(F(t_("Impossible to read file '%s'"), fileName));
-			}
+			if (!IsAvailable())
+				throw Exc(F(t_("Impossible to read file '%s'"), fileName));
+			
 			UVector<String> vars = Split(var, "/");
-			if (vars.size() == 2) {
-				isChanged = true;
-				return SetFASTVar(fileText, vars[1], val, vars[0]);
-			} else if (vars.size() == 1) {
-				isChanged = true;	
-				return SetFASTVar(fileText, vars[0], val);
-			} else
+			if (vars.size() == 2) 
+				SetVar(vars[1], val, vars[0]);
+			else if (vars.size() == 1) 
+				SetVar(vars[0], val, Null);
+			else
 				throw Exc(F(t_("Wrong variable '%s' in SetString"), var));
+			isChanged = true;
 		}
-		void GetMatrixIds(String var, int row, int col, int &posIni, int &posEnd) {
-			if (fileText.IsEmpty()) {
-				fileText = LoadFile(fileName);
-				if (fileText.IsEmpty())
-					throw Exc(F(t_("Impossible to read file '%s'"), fileName));
-			}
-			GetFASTMatrixIds(fileText, var, row, col, posIni, posEnd);
-		}
+		void SetVar(const String &var, const String &value, const String &paragraph);
 	};
 	
 public:
@@ -943,9 +1100,41 @@ public:
 	//double T, r2;
 };
 
+// Matrix of FAST cases, with a case folder for every combination of the values of the variables (wind seeds, sea states, yaw, decay offsets...).
+// Only the files with variables are written in every case. The rest are hard linked to the seed files, or copied if links are not supported
+class FASTCaseMatrix {
+public:
+	// var as "hydrodyn:WaveHs" or "elastodyn:PtfmHeave", and values as "2,4,6"
+	void AddVar(String var, String values);
+	int GetCount() const;
+	
+	// seed is a .fst file, a folder with one, or an input .dat file for variables of a single type
+	String Create(String seed, String folder, int numThreads = Null, Function <bool(String, int)> Status = Null);
+	
+	int numWritten = 0, numLinked = 0, numCopied = 0;
+	
+private:
+	struct Var {
+		int idFile;
+		String name;
+		UVector<String> values;
+	};
+	UArray<Var> vars;
+	
+	static const char *fileTypes[];
+	static FASTCase::File &GetFile(FASTCase &cas, int idFile);
+};
+
 double GetDecayPeriod(FastOut &fst, BasicBEM::DOF dof, double &r2);
 
 double GetRAO(const VectorXd &data, const VectorXd &time, double T, bool onlyFFT, double r2Max);
 void GetWaveRegularAmplitude(const FastOut &dataFast, double &T, double &A);
+
+// Rainflow cycle counting (ASTM E1049-85). Every cycle has its range, mean and count (1 or 0.5 for the residue)
+void Rainflow(const VectorXd &data, UVector<double> &ranges, UVector<double> &means, UVector<double> &counts);
+// Damage equivalent load for Wöhler exponent m, as the range that gives the same damage in neq cycles
+double GetDEL(const UVector<double> &ranges, const UVector<double> &counts, double m, double neq);
+double GetDEL(const VectorXd &data, double m, double neq);
+String BenchmarkRainflow(int num, double &astmCycles);
 	
 #endif
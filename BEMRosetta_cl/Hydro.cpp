@@ -482,6 +482,137 @@ UVector<int> NumSets(int num, int numsets) {
 	return ret;
 }
 
+// Splits cost in numsets consecutive sets, minimizing the cost of the most expensive one
+UVector<int> CostSets(const UVector<double> &cost, int numsets) {
+	int num = cost.size();
+	ASSERT(numsets > 0 && numsets <= num);
+	
+	UVector<double> acc(num + 1);
+	acc[0] = 0;
+	for (int i = 0; i < num; ++i)
+		acc[i+1] = acc[i] + cost[i];
+	
+	// best(is, i): lowest maximum cost when the first i values are split in is+1 sets
+	MatrixXd best = MatrixXd::Constant(numsets, num + 1, std::numeric_limits<double>::max());
+	MatrixXi from = MatrixXi::Zero(numsets, num + 1);
+	for (int i = 1; i <= num; ++i)
+		best(0, i) = acc[i];
+	for (int is = 1; is < numsets; ++is) {
+		for (int i = is + 1; i <= num; ++i) {
+			for (int j = is; j < i; ++j) {
+				double val = max(best(is-1, j), acc[i] - acc[j]);
+				if (val < best(is, i)) {
+					best(is, i) = val;
+					from(is, i) = j;
+				}
+			}
+		}
+	}
+	UVector<int> ret;
+	ret.SetCount(numsets);
+	for (int is = numsets-1, i = num; is >= 0; --is) {
+		int j = is > 0 ? from(is, i) : 0;
+		ret[is] = i - j;
+		i = j;
+	}
+	return ret;
+}
+
+UVector<double> Hydro::GetCaseCost(bool irregular, int qtfType) const {
+	UVector<double> cost(dt.Nf);
+	
+	if (!IsNull(Bem().caseProfile)) {		// Timing profile from a previous run: frequency, time
+		FileInLine in(Bem().caseProfile);
+		if (!in.IsOpen())
+			throw Exc(F(t_("Impossible to open timing profile '%s'"), Bem().caseProfile));
+		
+		UVector<Pointf> prof;
+		while (!in.IsEof()) {
+			UVector<String> vals = Split(in.GetLine(), [](int c)->int {return c == ',' || c == ';' || IsTabSpace(c);}, true);
+			if (vals.size() < 2)
+				continue;
+			double w = ScanDouble(vals[0]), t = ScanDouble(vals[1]);
+			if (IsNum(w) && IsNum(t))
+				prof << Pointf(w, t);
+		}
+		if (prof.size() < 2)
+			throw Exc(F(t_("Timing profile '%s' has to include at least two frequency, time rows"), Bem().caseProfile));
+		StableSort(prof, [](const Pointf &a, const Pointf &b) {return a.x < b.x;});
+		
+		UVector<double> vw, vt;
+		for (const Pointf &p : prof) {
+			vw << p.x;
+			vt << p.y;
+		}
+		for (int ifr = 0; ifr < dt.Nf; ++ifr)
+			cost[ifr] = max(0., LinearInterpolate(minmax(dt.w[ifr], vw[0], vw.Top()), vw, vt));
+		return cost;
+	}
+	
+	// Estimation. Per frequency, the influence coefficients are O(N²), with a Green function 
+	// more expensive as the wave length gets shorter compared with the body, and the 
+	// linear system is O(N³). Each QTF frequency is combined with the previous ones
+	double N = 0, len = 0;
+	for (int ib = 0; ib < dt.msh.size(); ++ib) {
+		const Surface &mesh = dt.msh[ib].dt.mesh;
+		N += mesh.panels.size();
+		if (!mesh.IsEmpty())
+			len = max(len, max(mesh.env.maxX - mesh.env.minX, mesh.env.maxY - mesh.env.minY));
+		if (irregular && ib < dt.lids.size())
+			N += dt.lids[ib].dt.mesh.panels.size();
+	}
+	N = max(N, 1.);
+	double g = IsNum(dt.g) ? dt.g : Bem().g;
+	
+	UVector<int> order = GetSortOrderX(dt.w);
+	for (int i = 0; i < dt.Nf; ++i) {
+		int ifr = order[i];
+		double k = sqr(dt.w[ifr])/g;
+		cost[ifr] = N*N*(1 + k*len) + N*N*N/1000;
+		if (qtfType > 0)
+			cost[ifr] += N*(i + 1);
+	}
+	return cost;
+}
+
+UVector<int> Hydro::GetCaseSets(int numCases, bool irregular, int qtfType) const {
+	if (!Bem().opCaseBalance)
+		return NumSets(dt.Nf, numCases);
+	
+	UVector<double> cost = GetCaseCost(irregular, qtfType);
+	UVector<int> ret = CostSets(cost, numCases);
+	
+	double total = 0;
+	for (double c : cost)
+		total += c;
+	if (total <= 0)
+		return NumSets(dt.Nf, numCases);
+	
+	auto MaxLoad = [&](const UVector<int> &sets) {
+		double mx = 0;
+		for (int is = 0, ifr = 0; is < sets.size(); ifr += sets[is], ++is) {
+			double load = 0;
+			for (int i = ifr; i < ifr + sets[is]; ++i)
+				load += cost[i];
+			mx = max(mx, load);
+		}
+		return mx;
+	};
+	
+	BEM::Print("\n" + F(t_("Frequencies split in %d cases balancing the predicted load (%s)"), numCases, 
+					IsNull(Bem().caseProfile) ? t_("estimated") : F(t_("timing profile '%s'"), Bem().caseProfile)));
+	for (int is = 0, ifr = 0; is < ret.size(); ifr += ret[is], ++is) {
+		double load = 0;
+		for (int i = ifr; i < ifr + ret[is]; ++i)
+			load += cost[i];
+		BEM::Print("\n" + F(t_("Case %d: %d frequencies from %.4f to %.4f rad/s. Predicted load %.1f%%"), 
+					is+1, ret[is], dt.w[ifr], dt.w[ifr + ret[is] - 1], 100*load/total));
+	}
+	BEM::Print("\n" + F(t_("Highest predicted load %.1f%% (%.1f%% with equal split)"), 
+					100*MaxLoad(ret)/total, 100*MaxLoad(NumSets(dt.Nf, numCases))/total));
+	return ret;
+}
+
 String FormatWam(double d) {
 	if (!IsNum(d))
 		return "0.0";
@@ -3279,7 +3410,7 @@ bool Hydro::IsHAMS(String file, String &controlfile) {
 	return true;
 }
 
-int Hydro::LoadHydro(UArray<Hydro> &hydros, String file, Function <bool(String, int)> Status) {
+int Hydro::LoadHydro(UArray<Hydro> &hydros, String file, Function <bool(String, int)> Status, bool afterLoad) {
 	String ext = ToLower(GetFileExt(file));
 	String ret;
 	
@@ -3335,11 +3466,17 @@ int Hydro::LoadHydro(UArray<Hydro> &hydros, String file, Function <bool(String,
 		hydros.SetCount(hydros.size() - num);
 		throw Exc(ret);//F(t_("Problem loading '%s'\n%s"), file, error));	
 	}
+	if (!afterLoad)
+		return num;
 	
 	for (int i = hydros.size() - num; i < hydros.size(); ++i) {
 		Hydro &hy = hydros[i];
 
-		ret = hy.AfterLoad(Status);
+		String cacheKey;
+		if (Bem().opCache && ext != ".bemr")		// .bemr already includes the derived data
+			cacheKey = Hydro::GetCacheKey(file, i - (hydros.size() - num));
+		
+		ret = hy.AfterLoad(Status, cacheKey);
 		if (!ret.IsEmpty()) {
 			//String error = RemoveAccents(ret);
 			hydros.SetCount(hydros.size() - num);
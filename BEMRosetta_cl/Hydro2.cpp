@@ -7,6 +7,7 @@
 #include "functions.h"
 #include <STEM4U/SeaWaves.h>
 #include <MatIO/matio.h>
+#include <plugin/zstd/zstd.h>
 
 using namespace Upp;
 using namespace Eigen;
@@ -1619,54 +1620,314 @@ void Hydro::Join(const UVector<Hydro *> &hydrosp) {
 	Initialize_Forces(dt.ex);
 	Initialize_Forces(dt.sc);
 	Initialize_Forces(dt.fk);
+	Initialize_Forces(dt.rao);
 		
-	for (int ihy = 0; ihy < hydrosp.size(); ++ihy) {
-		const Hydro &hy = *hydrosp[ihy];
-		
-		// All this block should have to be the same. Now it is not tested
-		
-		dt.solver = hy.dt.solver;
-		
+	for (int ihy = 0; ihy < hydrosp.size(); ++ihy) 
+		JoinAdd(*hydrosp[ihy]);
+	
+	if (!IsLoadedRAO())
+		dt.rao.Clear();
+}
+
+// Adds the data of hy to the frequencies and headings already set in the joined model
+void Hydro::JoinAdd(const Hydro &hy) {
+	// All this block should have to be the same. Now it is not tested
+	
+	dt.solver = hy.dt.solver;
+	
+	for (int ib = 0; ib < dt.Nb; ++ib) {
+		if (!hy.dt.msh[ib].dt.name.IsEmpty())
+			dt.msh[ib].dt.name = hy.dt.msh[ib].dt.name;
+		dt.msh[ib].dt.Vo = hy.dt.msh[ib].dt.Vo;
+		dt.msh[ib].dt.cg = clone(hy.dt.msh[ib].dt.cg);
+		dt.msh[ib].dt.c0 = clone(hy.dt.msh[ib].dt.c0);
+		for (int i = 0; i < 3; ++i) {
+			if (IsNum(hy.dt.msh[ib].dt.cb[i]))
+				dt.msh[ib].dt.cb[i] = hy.dt.msh[ib].dt.cb[i];
+		}
+	}
+	
+	if (hy.IsLoadedC()) {
 		for (int ib = 0; ib < dt.Nb; ++ib) {
-			if (!hy.dt.msh[ib].dt.name.IsEmpty())
-				dt.msh[ib].dt.name = hy.dt.msh[ib].dt.name;
-			dt.msh[ib].dt.Vo = hy.dt.msh[ib].dt.Vo;
-			dt.msh[ib].dt.cg = clone(hy.dt.msh[ib].dt.cg);
-			dt.msh[ib].dt.c0 = clone(hy.dt.msh[ib].dt.c0);
-			for (int i = 0; i < 3; ++i) {
-				if (IsNum(hy.dt.msh[ib].dt.cb[i]))
-					dt.msh[ib].dt.cb[i] = hy.dt.msh[ib].dt.cb[i];
+			for (int idf = 0; idf < 6; ++idf) 
+				for (int jdf = 0; jdf < 6; ++jdf) 
+					dt.msh[ib].dt.C(idf, jdf) = hy.C_ndim(ib, idf, jdf);
+		}
+	}
+	///////////////////////////////////////////////////////////////////
+	
+	if (hy.IsLoadedA() && hy.IsLoadedB()) {
+		for (int ifrhy = 0; ifrhy < hy.dt.Nf; ++ifrhy) {
+			int ifr = FindClosest(dt.w, hy.dt.w[ifrhy]);
+			for (int idf = 0; idf < 6*dt.Nb; ++idf) {
+				for (int jdf = 0; jdf < 6*dt.Nb; ++jdf) {	
+					if (IsNum(hy.dt.A[idf][jdf][ifrhy]))
+						dt.A[idf][jdf][ifr] = hy.A_ndim(ifrhy, idf, jdf);
+					if (IsNum(hy.dt.B[idf][jdf][ifrhy]))
+						dt.B[idf][jdf][ifr] = hy.B_ndim(ifrhy, idf, jdf);
+				}
 			}
 		}
+	}	
+	Add_Forces(dt.ex, hy, hy.dt.ex);
+	Add_Forces(dt.sc, hy, hy.dt.sc);
+	Add_Forces(dt.fk, hy, hy.dt.fk);
+	
+	Add_RAO(dt.rao, hy, hy.dt.rao);
+}
+
+int64 Hydro::GetMemory() const {
+	int64 num = 0;
+	for (const UArray<UArray<VectorXd>> *a : {&dt.A, &dt.B})
+		for (const auto &ai : *a)
+			for (const VectorXd &v : ai)
+				num += v.size()*sizeof(double);
+	for (const Forces *f : {&dt.ex, &dt.sc, &dt.fk, &dt.rao})
+		for (const auto &fb : *f)
+			for (const MatrixXcd &m : fb)
+				num += m.size()*sizeof(std::complex<double>);
+	return num;
+}
+
+void Hydro::JoinFiles(const UVector<String> &files, Function <bool(String, int)> Status) {
+	if (files.size() < 2)
+		throw Exc(t_("Please select more than one model"));
+	
+	// The files are read twice, so the first pass is the first half of the progress.
+	// The progress of each file load is scaled to its part of the total
+	auto Progress = [&](String str, int pos) {
+		if (Status && !Status(str, 100*pos/(2*files.size())))
+			throw Exc(t_("Cancelled by the user"));
+	};
+	auto LoadStatus = [&](int id) {
+		return [&, id](String str, int pos)->bool {
+			return !Status || Status(str, int(100*(id + minmax(pos, 0, 100)/100.)/(2*files.size())));
+		};
+	};
+	
+	dt.name = t_("Joined files");
+	dt.dimen = false;
+	dt.g = Bem().g;
+	dt.rho = Bem().rho;
+	dt.len = 1;
+	dt.h = Null;
+	dt.Nb = Null;
+	dt.head.Clear();
+	dt.w.Clear();
+	
+	// First pass: the frequencies and headings of all the models, so the joined arrays are sized only once.
+	// The models are just read, without AfterLoad(), so headings are set here in the range AfterLoad() sets
+	bool isName = false;
+	String name0;
+	double h0 = Null;
+	for (int i = 0; i < files.size(); ++i) {
+		Progress(F(t_("Scanning '%s'"), GetFileName(files[i])), i);
 		
-		if (hy.IsLoadedC()) {
-			for (int ib = 0; ib < dt.Nb; ++ib) {
-				for (int idf = 0; idf < 6; ++idf) 
-					for (int jdf = 0; jdf < 6; ++jdf) 
-						dt.msh[ib].dt.C(idf, jdf) = hy.C_ndim(ib, idf, jdf);
+		UArray<Hydro> loaded;
+		LoadHydro(loaded, files[i], LoadStatus(i), false);
+		for (const Hydro &hy : loaded) {
+			if (!isName && hy.dt.name.Find("Nemoh_Part") >= 0) {
+				dt.name = GetFileTitle(GetFileFolder(GetFileFolder(hy.dt.file)));
+				isName = true;
+			}
+			if (IsNull(dt.Nb)) {
+				name0 = hy.dt.name;
+				h0 = hy.dt.h;
+				dt.Nb = hy.dt.Nb;
+				if (!IsNum(dt.Nb))
+					throw Exc(t_("No body found in models"));
+			} else if (dt.Nb != hy.dt.Nb)
+				throw Exc(F(t_("Number of bodies does not match between '%s'(%d) and '%s'(%d)"), 
+						name0, dt.Nb, hy.dt.name, hy.dt.Nb));
+			if (IsNum(hy.dt.h))
+				dt.h = hy.dt.h;
+			else if (dt.h != hy.dt.h)
+				throw Exc(F(t_("Water depth does not match between '%s'(%d) and '%s'(%d)"), 
+						name0, h0, hy.dt.name, hy.dt.h));
+			
+			if (hy.IsLoadedFex() || hy.IsLoadedFsc() || hy.IsLoadedFfk()) {
+				for (int ih = 0; ih < hy.dt.head.size(); ih++) {
+					double head_v = FixHeading(hy.dt.head[ih], BasicBEM::HEAD_0_360);
+					FindAddRatio(dt.head, head_v, 0.001);
+				}
+			}
+			if (hy.IsLoadedA() && hy.IsLoadedB()) {
+				for (int ifr = 0; ifr < hy.dt.w.size(); ifr++) {
+					double w_v = hy.dt.w[ifr];
+					FindAddRatio(dt.w, w_v, 0.001);
+				}
 			}
 		}
-		///////////////////////////////////////////////////////////////////
+	}												// Each model is released once scanned
+	if (!IsNum(dt.h))
+		throw Exc(t_("No water depth found in models"));
+	dt.Nh = dt.head.size();
+	if (dt.Nh == 0)
+		throw Exc(t_("No head found in models"));
+	Sort(dt.w);
+	dt.Nf = dt.w.size();
+	if (dt.Nf == 0)
+		throw Exc(t_("No frequency found in models"));
+	
+	dt.msh.SetCount(dt.Nb);
+	Initialize_AB(dt.A);
+	Initialize_AB(dt.B);
+	for (int ib = 0; ib < dt.Nb; ++ib) 
+		dt.msh[ib].dt.C.setConstant(6, 6, NaNDouble);
+	Initialize_Forces(dt.ex);
+	Initialize_Forces(dt.sc);
+	Initialize_Forces(dt.fk);
+	Initialize_Forces(dt.rao);
+	
+	// Second pass: the data of each model is copied in place
+	for (int i = 0; i < files.size(); ++i) {
+		Progress(F(t_("Joining '%s'"), GetFileName(files[i])), files.size() + i);
 		
-		if (hy.IsLoadedA() && hy.IsLoadedB()) {
-			for (int ifrhy = 0; ifrhy < hy.dt.Nf; ++ifrhy) {
-				int ifr = FindClosest(dt.w, hy.dt.w[ifrhy]);
-				for (int idf = 0; idf < 6*dt.Nb; ++idf) {
-					for (int jdf = 0; jdf < 6*dt.Nb; ++jdf) {	
-						if (IsNum(hy.dt.A[idf][jdf][ifrhy]))
-							dt.A[idf][jdf][ifr] = hy.A_ndim(ifrhy, idf, jdf);
-						if (IsNum(hy.dt.B[idf][jdf][ifrhy]))
-							dt.B[idf][jdf][ifr] = hy.B_ndim(ifrhy, idf, jdf);
-					}
-				}
+		UArray<Hydro> loaded;
+		LoadHydro(loaded, files[i], LoadStatus(files.size() + i));
+		for (const Hydro &hy : loaded) 
+			JoinAdd(hy);
+	}												// Each model is released once added
+	Progress(t_("Models joined"), 2*files.size());
+	
+	if (!IsLoadedRAO())
+		dt.rao.Clear();
+}
+
+String Hydro::BenchmarkJoin(const UVector<String> &files, int &nf, String fileRef) {
+	// Peak data memory is estimated from the size of the arrays held at once, as the heap
+	// counters do not include the Eigen allocations
+	
+	// All the models loaded and then joined, as BEM::Join()
+	TimeStop t;
+	Hydro hyMem;
+	int64 memLoaded = 0, memLargest = 0;
+	{
+		UArray<Hydro> loaded;
+		for (const String &file : files) {
+			int num = loaded.size();
+			LoadHydro(loaded, file, Null);
+			int64 memFile = 0;
+			for (int i = num; i < loaded.size(); ++i)
+				memFile += loaded[i].GetMemory();
+			memLoaded += memFile;
+			memLargest = max(memLargest, memFile);
+		}
+		UVector<Hydro *> hydrosp;
+		for (Hydro &hy : loaded)
+			hydrosp << &hy;
+		hyMem.Join(hydrosp);
+	}
+	double tMem = t.Seconds();
+	int64 peakMem = memLoaded + hyMem.GetMemory();
+	
+	// One model at a time, so only the joined model and the largest file are in memory at once
+	t.Reset();
+	Hydro hyStream;
+	hyStream.JoinFiles(files, Null);
+	double tStream = t.Seconds();
+	int64 peakStream = memLargest + hyStream.GetMemory();
+	
+	auto EqualV = [](const VectorXd &a, const VectorXd &b) {
+		return a.size() == b.size() && (a.array() == b.array() || (a.array().isNaN() && b.array().isNaN())).all();
+	};
+	auto EqualAB = [&](const UArray<UArray<VectorXd>> &a, const UArray<UArray<VectorXd>> &b) {
+		if (a.size() != b.size())
+			return false;
+		for (int i = 0; i < a.size(); ++i) {
+			if (a[i].size() != b[i].size())
+				return false;
+			for (int j = 0; j < a[i].size(); ++j) 
+				if (!EqualV(a[i][j], b[i][j]))
+					return false;
+		}
+		return true;
+	};
+	auto EqualF = [&](const Forces &a, const Forces &b) {
+		if (a.size() != b.size())
+			return false;
+		for (int ib = 0; ib < a.size(); ++ib) {
+			if (a[ib].size() != b[ib].size())
+				return false;
+			for (int ih = 0; ih < a[ib].size(); ++ih) {
+				const MatrixXcd &ma = a[ib][ih], &mb = b[ib][ih];
+				if (ma.rows() != mb.rows() || ma.cols() != mb.cols())
+					return false;
+				for (int c = 0; c < ma.cols(); ++c)
+					if (!EqualV(ma.col(c).real(), mb.col(c).real()) || !EqualV(ma.col(c).imag(), mb.col(c).imag()))
+						return false;
 			}
-		}	
-		Add_Forces(dt.ex, hy, hy.dt.ex);
-		Add_Forces(dt.sc, hy, hy.dt.sc);
-		Add_Forces(dt.fk, hy, hy.dt.fk);
+		}
+		return true;
+	};
+	if (!IsEqualRange(hyMem.dt.w, hyStream.dt.w) || !IsEqualRange(hyMem.dt.head, hyStream.dt.head) || 
+		!EqualAB(hyMem.dt.A, hyStream.dt.A) || !EqualAB(hyMem.dt.B, hyStream.dt.B) ||
+		!EqualF(hyMem.dt.ex, hyStream.dt.ex) || !EqualF(hyMem.dt.sc, hyStream.dt.sc) || !EqualF(hyMem.dt.fk, hyStream.dt.fk))
+		throw Exc(t_("The joined models do not match"));
+	
+	if (!IsNull(fileRef)) {		// The joined model has to match the unsplit one, looking for its frequencies and headings
+		UArray<Hydro> loaded;
+		LoadHydro(loaded, fileRef, Null);
+		if (loaded.IsEmpty())
+			throw Exc(F(t_("No model found in '%s'"), fileRef));
+		const Hydro &ref = loaded[0];
+		const Hydro &hy = hyStream;
 		
-		Add_RAO(dt.rao, hy, hy.dt.rao);
-	}
+		if (ref.dt.Nb != hy.dt.Nb || ref.dt.Nf != hy.dt.Nf || ref.dt.Nh != hy.dt.Nh)
+			throw Exc(F(t_("The joined model has %d bodies, %d frequencies and %d headings, and '%s' has %d, %d and %d"), 
+						hy.dt.Nb, hy.dt.Nf, hy.dt.Nh, GetFileName(fileRef), ref.dt.Nb, ref.dt.Nf, ref.dt.Nh));
+		UVector<int> idw(hy.dt.Nf), idh(hy.dt.Nh);
+		for (int ifr = 0; ifr < hy.dt.Nf; ++ifr) {
+			idw[ifr] = FindRatio(ref.dt.w, hy.dt.w[ifr], 0.001);
+			if (idw[ifr] < 0)
+				throw Exc(F(t_("Frequency %f is not in '%s'"), hy.dt.w[ifr], GetFileName(fileRef)));
+		}
+		for (int ih = 0; ih < hy.dt.Nh; ++ih) {
+			idh[ih] = FindRatio(ref.dt.head, hy.dt.head[ih], 0.001);
+			if (idh[ih] < 0)
+				throw Exc(F(t_("Heading %f is not in '%s'"), hy.dt.head[ih], GetFileName(fileRef)));
+		}
+		auto Similar = [](double a, double b) {
+			return (!IsNum(a) && !IsNum(b)) || EqualRatio(a, b, 1E-6);
+		};
+		for (int ifr = 0; ifr < hy.dt.Nf; ++ifr) 
+			for (int idf = 0; idf < 6*hy.dt.Nb; ++idf) 
+				for (int jdf = 0; jdf < 6*hy.dt.Nb; ++jdf) {
+					if (hy.IsLoadedA() && !Similar(hy.A_dim(ifr, idf, jdf), ref.A_dim(idw[ifr], idf, jdf)))
+						throw Exc(F(t_("When comparing %s values, %f<>%f"), F(t_("%s[%d](%d, %d)"), t_("A"), ifr+1, idf+1, jdf+1), 
+									hy.A_dim(ifr, idf, jdf), ref.A_dim(idw[ifr], idf, jdf)));
+					if (hy.IsLoadedB() && !Similar(hy.B_dim(ifr, idf, jdf), ref.B_dim(idw[ifr], idf, jdf)))
+						throw Exc(F(t_("When comparing %s values, %f<>%f"), F(t_("%s[%d](%d, %d)"), t_("B"), ifr+1, idf+1, jdf+1), 
+									hy.B_dim(ifr, idf, jdf), ref.B_dim(idw[ifr], idf, jdf)));
+				}
+		auto CompareF = [&](const Forces &f, const Forces &fref, const char *type) {
+			if (f.IsEmpty() || fref.IsEmpty())
+				return;
+			for (int ib = 0; ib < hy.dt.Nb; ++ib)
+				for (int ih = 0; ih < hy.dt.Nh; ++ih) 	
+					for (int ifr = 0; ifr < hy.dt.Nf; ++ifr)
+						for (int idf = 0; idf < 6; ++idf) {
+							std::complex<double> Fa = hy.F_dim(f, ih, ifr, idf, ib),
+												 Fb = ref.F_dim(fref, idh[ih], idw[ifr], idf, ib);
+							if (!Similar(Fa.real(), Fb.real()) || !Similar(Fa.imag(), Fb.imag()))
+								throw Exc(F(t_("When comparing %s values, %f:%f<>%f:%f"), 
+										F(t_("%s[%d][%d](%d, %d)"), type, ib+1, ih+1, ifr+1, idf+1), 
+										Fa.real(), Fa.imag(), Fb.real(), Fb.imag()));
+						}
+		};
+		CompareF(hy.dt.ex, ref.dt.ex, t_("Excitation forces"));
+		CompareF(hy.dt.sc, ref.dt.sc, t_("Scattering forces"));
+		CompareF(hy.dt.fk, ref.dt.fk, t_("Froude-Krylov forces"));
+	}
+	nf = hyStream.dt.Nf;
+	
+	String ret;
+	ret << F(t_("%d models joined, with %d frequencies and %d headings"), files.size(), hyStream.dt.Nf, hyStream.dt.Nh);
+	if (!IsNull(fileRef))
+		ret << "\n" << F(t_("The joined model matches '%s'"), GetFileName(fileRef));
+	ret << "\n" << F(t_("In memory: %.3f s, data peak %.1f MB"), tMem, peakMem/1E6);
+	ret << "\n" << F(t_("Streamed:  %.3f s, data peak %.1f MB"), tStream, peakStream/1E6);
+	return ret;
 }
 
 void Hydro::Report() const {
@@ -1796,7 +2057,133 @@ void Hydro::LoadListPointsTemp(UVector<bool> &idPanels, MatrixXi &idPanelsM, UVe
 	listPointsTemp.Clear();
 }
 
-String Hydro::AfterLoad(Function <bool(String, int)> Status) {
+// Data obtained in AfterLoad() that is stored in the cache. 
+// Increment version when the stored fields or how they are calculated change
+struct HydroCache {
+	static const int version = 1;
+	
+	String key;
+	int Nb = Null, Nf = Null, Nh = Null;
+	UArray<UArray<VectorXd>> Kirf, Ainf_w, A_P, B_P;
+	VectorXd Tirf;
+	MatrixXd Ainf, A0;
+	Hydro::Forces sc_pot, fk_pot, fk_pot_bmr;
+	UArray<UArray<UArray<UArray<std::complex<double>>>>> pots_inc_bmr;
+	
+	void Jsonize(JsonIO &json) {
+		json
+			("key", key)
+			("Nb", Nb)
+			("Nf", Nf)
+			("Nh", Nh)
+			("Kirf", Kirf)
+			("Tirf", Tirf)
+			("Ainf", Ainf)
+			("Ainf_w", Ainf_w)
+			("A0", A0)
+			("A_P", A_P)
+			("B_P", B_P)
+			("sc_pot", sc_pot)
+			("fk_pot", fk_pot)
+			("fk_pot_bmr", fk_pot_bmr)
+			("pots_inc_bmr", pots_inc_bmr)
+		;
+	}
+};
+
+// The key hashes the file contents, the size and date of the files around it (other solver 
+// outputs or meshes), and the options used in AfterLoad()
+String Hydro::GetCacheKey(String file, int id) {
+	FileIn in(file);
+	if (!in)
+		return String();
+	
+	Sha1Stream sha;
+	Buffer<byte> buffer(1 << 16);
+	int len;
+	while ((len = in.Get(buffer, 1 << 16)) > 0)
+		sha.Put(buffer, len);
+	
+	UVector<String> files;
+	auto AddFolder = [&](String folder, auto &Recurse, int level) -> void {
+		for (FindFile ff(AFX(folder, "*.*")); ff; ff.Next()) {
+			if (ff.IsFile())
+				files << F("%s;%d;%s", ff.GetPath(), ff.GetLength(), Format(Time(ff.GetLastWriteTime())));
+			else if (ff.IsFolder() && level < 1)
+				Recurse(ff.GetPath(), Recurse, level + 1);
+		}
+	};
+	AddFolder(GetFileFolder(file), AddFolder, 0);
+	Sort(files);
+	for (const String &f : files)
+		sha << f << "\n";
+	
+	sha << F("%d;%d;%.17g;%d;%d;%d;%.17g;%.17g", HydroCache::version, id, Bem().maxTimeA, Bem().numValsA, 
+				Bem().calcAinf, Bem().calcAinf_w, Bem().rho, Bem().g);
+	
+	return sha.FinishString();
+}
+
+bool Hydro::LoadCache(String cacheKey) {
+	String fileName = AFX(Bem().GetCacheFolder(), cacheKey + ".bmrc");
+	if (!FileExists(fileName))
+		return false;
+	
+	HydroCache cache;
+	String data = ZstdDecompress(LoadFile(fileName));
+	if (data.IsEmpty() || !LoadFromJson(cache, data) || cache.key != cacheKey || 
+		cache.Nb != dt.Nb || cache.Nf != dt.Nf || cache.Nh != dt.Nh) {
+		DeleteFile(fileName);		// Corrupt or stale entries are not reused
+		return false;
+	}
+	dt.Kirf = pick(cache.Kirf);
+	dt.Tirf = pick(cache.Tirf);
+	dt.Ainf = pick(cache.Ainf);
+	dt.Ainf_w = pick(cache.Ainf_w);
+	dt.A0 = pick(cache.A0);
+	dt.A_P = pick(cache.A_P);
+	dt.B_P = pick(cache.B_P);
+	dt.sc_pot = pick(cache.sc_pot);
+	dt.fk_pot = pick(cache.fk_pot);
+	dt.fk_pot_bmr = pick(cache.fk_pot_bmr);
+	dt.pots_inc_bmr = pick(cache.pots_inc_bmr);
+	
+	return true;
+}
+
+void Hydro::SaveCache(String cacheKey) const {
+	String folder = Bem().GetCacheFolder();
+	if (!DirectoryCreateX(folder)) {
+		BEM::PrintWarning("\n" + F(t_("Impossible to create cache folder '%s'"), folder));
+		return;
+	}
+	HydroCache cache;
+	cache.key = cacheKey;
+	cache.Nb = dt.Nb;
+	cache.Nf = dt.Nf;
+	cache.Nh = dt.Nh;
+	cache.Kirf = clone(dt.Kirf);
+	cache.Tirf = dt.Tirf;
+	cache.Ainf = dt.Ainf;
+	cache.Ainf_w = clone(dt.Ainf_w);
+	cache.A0 = dt.A0;
+	cache.A_P = clone(dt.A_P);
+	cache.B_P = clone(dt.B_P);
+	cache.sc_pot = clone(dt.sc_pot);
+	cache.fk_pot = clone(dt.fk_pot);
+	cache.fk_pot_bmr = clone(dt.fk_pot_bmr);
+	cache.pots_inc_bmr = clone(dt.pots_inc_bmr);
+	
+	// Saved with a temporary name so that an interrupted write is never read as valid
+	String fileName = AFX(folder, cacheKey + ".bmrc");
+	String fileTemp = fileName + ".tmp";
+	if (!SaveFile(fileTemp, ZstdCompress(StoreAsJson(cache))) || !FileMove(fileTemp, fileName)) {
+		DeleteFile(fileTemp);
+		BEM::PrintWarning("\n" + F(t_("Impossible to save cache file '%s'"), fileName));
+	}
+}
+
+String Hydro::AfterLoad(Function <bool(String, int)> Status, String cacheKey) {
 	if (IsNull(dt.len) || dt.len < 0)
 		return t_("Incorrect length in model");
 	if (IsNull(dt.dimen))
@@ -1812,7 +2199,16 @@ String Hydro::AfterLoad(Function <bool(String, int)> Status) {
 	Status(t_("Sorting frequencies and headings"), -1);
 	SortFrequencies();
 	SortHeadings(BasicBEM::HEAD_0_360, BasicBEM::HEAD_0_360, BasicBEM::HEAD_0_360);
-		
+	
+	bool cached = false;
+	if (!IsNull(cacheKey)) {
+		Status(t_("Looking for derived data in cache"), -1);
+		if ((cached = LoadCache(cacheKey))) {
+			Bem().cacheHits++;
+			BEM::Print(F("\n") + t_("Kirf, A∞, A∞(ω) and potentials data loaded from cache"));
+		}
+	}
+	
 	if ((!IsLoadedAinf() || !IsLoadedKirf()) && Bem().calcAinf) {
 		Status(t_("Obtaining Ainf, Kirf, and A0"), -1);
 		
@@ -1834,7 +2230,7 @@ String Hydro::AfterLoad(Function <bool(String, int)> Status) {
 			GetA0();
 	}
 		
-	if (Bem().calcAinf_w) {
+	if (Bem().calcAinf_w && !cached) {
 		Status(t_("Obtaining Ainf_w"), -1);
 		
 		if (!IsLoadedKirf())
@@ -1950,25 +2346,31 @@ String Hydro::AfterLoad(Function <bool(String, int)> Status) {
 				m.dt.C = C;
 		}
 	}
-	if (IsLoadedPotsRad()) {
-		Status(t_("Obtaining A and B from potentials"), -1);	
-		GetABFromPotentials();
-	}  
-    if (IsLoadedPotsInc()) {	
-        Status(t_("Obtaining Ffk from potentials"), -1);
-        GetForcesFromPotentials(dt.pots_inc, dt.fk_pot);
-	}
-	if (!dt.msh.IsEmpty() && !IsLoadedPotsIncBMR()) {
-		Status(t_("Obtaining incident potentials from mesh"), -1);
-		GetPotentialsIncident();
-	}	
-	if (IsLoadedPotsIncBMR()) {	
-		Status(t_("Obtaining Ffk from bmr potentials"), -1);
-		GetForcesFromPotentials(dt.pots_inc_bmr, dt.fk_pot_bmr);
-	}
-	if (IsLoadedPotsDif()) {
-		Status(t_("Obtaining Fsc from potentials"), -1);		
-		GetForcesFromPotentials(dt.pots_dif, dt.sc_pot);
+	if (!cached) {
+		if (IsLoadedPotsRad()) {
+			Status(t_("Obtaining A and B from potentials"), -1);	
+			GetABFromPotentials();
+		}  
+	    if (IsLoadedPotsInc()) {	
+	        Status(t_("Obtaining Ffk from potentials"), -1);
+	        GetForcesFromPotentials(dt.pots_inc, dt.fk_pot);
+		}
+		if (!dt.msh.IsEmpty() && !IsLoadedPotsIncBMR()) {
+			Status(t_("Obtaining incident potentials from mesh"), -1);
+			GetPotentialsIncident();
+		}	
+		if (IsLoadedPotsIncBMR()) {	
+			Status(t_("Obtaining Ffk from bmr potentials"), -1);
+			GetForcesFromPotentials(dt.pots_inc_bmr, dt.fk_pot_bmr);
+		}
+		if (IsLoadedPotsDif()) {
+			Status(t_("Obtaining Fsc from potentials"), -1);		
+			GetForcesFromPotentials(dt.pots_dif, dt.sc_pot);
+		}
+		if (!IsNull(cacheKey)) {
+			Status(t_("Saving derived data in cache"), -1);
+			SaveCache(cacheKey);
+		}
 	}
 	
 	CompleteForces1st();
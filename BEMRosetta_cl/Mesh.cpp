@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 // Copyright 2020 - 2026, the BEMRosetta author and contributors
 #include "BEMRosetta.h"
+#include "BEMRosetta_int.h"
 
 	
 const UVector<Body::MeshInfo> Body::meshInfo = {
@@ -193,6 +194,70 @@ String Body::Load(UArray<Body> &mesh, String file, double rho, double g, bool cl
 	return ret;
 }
 	
+static bool IsIntField(const String &str) {
+	const char *s = ~str;
+	if (*s == '-' || *s == '+')
+		s++;
+	if (*s == '\0')
+		return false;
+	for (; *s != '\0'; ++s)
+		if (!IsDigit(*s))
+			return false;
+	return true;
+}
+
+// Returns the .dat parsers sorted by how well the file header matches them.
+// Only the first KB are read, so the right parser is usually the first one tried.
+// The parsers without any match are kept at the end in the old cascade order, as a fallback
+UVector<int> Body::SniffDat(String file) {
+	UVector<int> score(NUMDAT, 0);
+
+	FileIn in(file);
+	if (in.IsOpen()) {
+		UVector<String> lines = Split(in.Get(4096), '\n', false);
+		if (lines.size() > 1)
+			lines.Drop();		// Last line may be truncated
+		for (String &line : lines)
+			line = TrimRight(line);
+		
+		if (!lines.IsEmpty()) {
+			const String &line0 = lines[0];
+			UVector<String> f = Split(line0, IsTabSpace, true);
+			
+			if (ToUpper(TrimLeft(line0)).StartsWith("ZONE"))
+				score[DAT_WAMIT] = 10;
+			else if (line0.StartsWith("*********1*********2*********3"))
+				score[DAT_AQWA] = 10;
+			else if (line0.StartsWith("******************************")) {
+				for (int i = 1; i < min(4, lines.size()); ++i) {
+					if (lines[i].Find("ANSYS") >= 0) {
+						score[DAT_ANSYSTOAQWA] = 10;
+						break;
+					}
+				}
+			} else if (f.size() == 1 && f[0] == "*NODE")
+				score[DAT_DIODORE] = 10;
+			else if (f.size() == 2 && IsIntField(f[0]) && IsIntField(f[1])) {
+				if (ScanInt(f[0]) == 2)
+					score[DAT_NEMOH] = 10;
+				else if (ScanInt(f[0]) >= 10 && ScanInt(f[1]) >= 10)
+					score[DAT_SALOME] = 8;
+			} else if (f.size() == 4 && IsIntField(f[0]) && IsIntField(f[1]) && IsIntField(f[2]) && IsIntField(f[3])) {
+				int sym = ScanInt(f[0]);
+				if (sym == 0 || sym == 1)
+					score[DAT_NEMOHFS] = 10;
+			} else if (f.size() == 4 && IsIntField(f[0]) && !IsNull(ScanDouble(f[1])) 
+									 && !IsNull(ScanDouble(f[2])) && !IsNull(ScanDouble(f[3])))
+				score[DAT_DIODORE] = 5;		// Diodore without *NODE header
+		}
+	}
+	UVector<int> parsers;
+	for (int i = 0; i < NUMDAT; ++i)
+		parsers << i;
+	StableSort(parsers, [&](int a, int b) {return score[a] > score[b];});
+	return parsers;
+}
+
 String Body::Load(UArray<Body> &mesh, String file, double rho, double g, bool cleanPanels, double grid, double eps, 
 		bool &y0z, bool &x0z) {
 	String ext = ToLower(GetFileExt(file));
@@ -202,26 +267,25 @@ String Body::Load(UArray<Body> &mesh, String file, double rho, double g, bool cl
 	mesh.Clear();
 	
 	if (ext == ".dat") {
-		ret = NemohBody::LoadDat(mesh, file, x0z);
-		if (!ret.IsEmpty() && !ret.StartsWith(t_("Parsing error: "))) {
-			ret = NemohBody::LoadDatFS(mesh, file, x0z);
-			if (!ret.IsEmpty() && !ret.StartsWith(t_("Parsing error: "))) {
-				ret = SalomeBody::LoadDat(mesh, file);
-				if (!ret.IsEmpty() && !ret.StartsWith(t_("Parsing error: "))) {
-					ret = WamitBody::LoadDat(mesh, file);
-					if (!ret.IsEmpty() && !ret.StartsWith(t_("Parsing error: "))) {
-						ret = DiodoreBody::LoadDat(mesh, file);
-						if (!ret.IsEmpty() && !ret.StartsWith(t_("Parsing error: "))) { 	
-							Hydro hy;
-							ret = AQWABody::LoadDat(mesh, hy, file);
-							if (!ret.IsEmpty() && !ret.StartsWith(t_("Parsing error: "))) 
-								ret = AQWABody::LoadDatANSYSTOAQWA(mesh, hy, file);	
-							y0z = hy.dt.symX;
-							x0z = hy.dt.symY;
-						}
-					}
-				}
+		UVector<int> parsers = SniffDat(file);
+		for (int parser : parsers) {
+			mesh.Clear();
+			Hydro hy;
+			switch (parser) {
+			case DAT_NEMOH:			ret = NemohBody::LoadDat(mesh, file, x0z);					break;
+			case DAT_NEMOHFS:		ret = NemohBody::LoadDatFS(mesh, file, x0z);				break;
+			case DAT_SALOME:		ret = SalomeBody::LoadDat(mesh, file);						break;
+			case DAT_WAMIT:			ret = WamitBody::LoadDat(mesh, file);						break;
+			case DAT_DIODORE:		ret = DiodoreBody::LoadDat(mesh, file);						break;
+			case DAT_AQWA:			ret = AQWABody::LoadDat(mesh, hy, file);					break;
+			case DAT_ANSYSTOAQWA:	ret = AQWABody::LoadDatANSYSTOAQWA(mesh, hy, file);			break;
+			}
+			if (parser == DAT_AQWA || parser == DAT_ANSYSTOAQWA) {
+				y0z = hy.dt.symX;
+				x0z = hy.dt.symY;
 			}
+			if (ret.IsEmpty() || ret.StartsWith(t_("Parsing error: ")))
+				break;
 		}
 	} else if (ext == ".lis")
 		ret = AQWABody::LoadLis(mesh, file, g, y0z, x0z);
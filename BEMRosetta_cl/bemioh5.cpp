@@ -84,18 +84,9 @@ void BemioH5::Load_H5() {
 	dt.Ainf.setConstant(dt.Nb*6, dt.Nb*6, NaNDouble);
 	
 	Initialize_AB(dt.A);
-	UArray<UArray<VectorXd>> a;		
-	Initialize_AB(a);
-	
 	Initialize_AB(dt.B);
-	UArray<UArray<VectorXd>> b;		
-	Initialize_AB(b);
 	
 	Initialize_Forces();
-	Hydro::Forces ex, sc, fk;	
-	Initialize_Forces(ex);	
-	Initialize_Forces(sc); 
-	Initialize_Forces(fk);
 	
 	dt.msh.SetCount(dt.Nb);
 	for (int ib = 0; ib < dt.Nb; ++ib) 
@@ -126,6 +117,20 @@ void BemioH5::Load_H5() {
 				for (int iw = 0; iw < dt.Nf; ++iw) 
 					a[r + 6*ib][c](iw) = d(r, c, iw);
 	};
+	auto LoadAB = [&](UArray<UArray<VectorXd>> &a, int ib, bool isA) {
+		if (hfile.ExistDataset("all")) {			// Full array is faster to read than components
+			LoadAllAB(a, ib);
+			if (hfile.ExistGroup("components")) {	// Both are saved, so they have to match
+				UArray<UArray<VectorXd>> comp = clone(a);
+				LoadComponentsAB(comp, ib);
+				if (isA)
+					Compare_A(comp);
+				else
+					Compare_B(comp);
+			}
+		} else if (hfile.ExistGroup("components")) 
+			LoadComponentsAB(a, ib);
+	};
 	
 	auto LoadForce = [&](Hydro::Forces &f, int ib) {
 		MatrixXd data;
@@ -174,6 +179,17 @@ void BemioH5::Load_H5() {
 						f[ib][ih](iw, idf).imag(d(idf, ih, iw));			
 		}
 	};
+	auto LoadForces = [&](Hydro::Forces &f, int ib, String type) {
+		if (hfile.ExistDataset("re") || hfile.ExistDataset("im")) {
+			LoadForceAll(f, ib);
+			if (hfile.ExistGroup("components")) {		// Both are saved, so they have to match
+				Hydro::Forces comp = clone(f);
+				LoadForce(comp, ib);
+				Compare_F(comp, f, type);
+			}
+		} else
+			LoadForce(f, ib);
+	};
 	auto LoadMD = [&](UArray<UArray<UArray<VectorXd>>> &f, int ib) {	// [Nb][Nh][6](Nf)
 		MultiDimMatrixRowMajor<double> d;
 		if (hfile.ExistDataset("val")) {
@@ -214,10 +230,7 @@ void BemioH5::Load_H5() {
 			}
 			if (hfile.ChangeGroup("hydro_coeffs")) {
 				if (hfile.ChangeGroup("added_mass")) {
-					if (hfile.ExistDataset("all")) 
-						LoadAllAB(dt.A, ib);
-					if (hfile.ExistGroup("components")) 
-						LoadComponentsAB(a, ib);	
+					LoadAB(dt.A, ib, true);
 					
 					if (hfile.ExistDataset("inf_freq")) {
 						hfile.GetDouble("inf_freq", data);
@@ -228,24 +241,18 @@ void BemioH5::Load_H5() {
 					hfile.UpGroup();	
 				}
 				if (hfile.ChangeGroup("radiation_damping")) {
-					if (hfile.ExistDataset("all")) 
-						LoadAllAB(dt.B, ib);
-					if (hfile.ExistGroup("components")) 
-						LoadComponentsAB(b, ib);
+					LoadAB(dt.B, ib, false);
 						
 					hfile.UpGroup();	
 				}
 				if (hfile.ChangeGroup("excitation")) {
-					LoadForce(dt.ex, ib);
-					LoadForceAll(ex, ib);
+					LoadForces(dt.ex, ib, "Excitation forces");
 					if (hfile.ChangeGroup("froude-krylov")) {
-						LoadForce(dt.fk, ib);
-						LoadForceAll(fk, ib);
+						LoadForces(dt.fk, ib, "Froude-Krylov forces");
 						hfile.UpGroup();		
 					}
 					if (hfile.ChangeGroup("scattering")) {
-						LoadForce(dt.sc, ib);
-						LoadForceAll(sc, ib);
+						LoadForces(dt.sc, ib, "Scattering forces");
 						hfile.UpGroup();	
 					}
 					hfile.UpGroup();	
@@ -281,34 +288,76 @@ void BemioH5::Load_H5() {
 		}
 	}
 	
-	if (IsLoadedA())
-		Compare_A(a);
-	if (IsLoadedB())
-		Compare_B(b);
-	if (IsLoadedFex()) {
-		if (IsLoadedForce(ex))
-			Compare_F(dt.ex, ex, "Excitation forces");
-	} else
-		dt.ex = pick(ex);
-	if (IsLoadedFsc()) {
-		if (IsLoadedForce(sc))
-			Compare_F(dt.sc, sc, "Scattering forces");
-	} else
-		dt.sc = pick(sc);
-	if (IsLoadedFfk()) {
-		if (IsLoadedForce(fk))
-			Compare_F(dt.fk, fk, "Froude-Krylov forces");
-	} else
-		dt.fk = pick(fk);
-	
 	for (int ib = 0; ib < dt.msh.size(); ++ib)
 		if (IsNull(dt.msh[ib].dt.c0))
 			dt.msh[ib].dt.c0 = dt.msh[ib].dt.cg;
 }
 
+// Full arrays saved after closing the file, as chunked and deflate compressed datasets.
+// Values are got when saving, so only one array is in memory at a time
+struct BemioH5Array {
+	String path, description;
+	int n0, n1, n2;
+	Function<double(int, int, int)> Get;
+};
+
+static void SaveCompressed(String fileName, const UArray<BemioH5Array> &arrays) {
+	hid_t file = H5Fopen(fileName, H5F_ACC_RDWR, H5P_DEFAULT);
+	if (file < 0)
+		throw Exc(F(t_("Impossible to open '%s'"), fileName));
+	
+	for (const BemioH5Array &a : arrays) {
+		if (a.n0*a.n1*a.n2 == 0)
+			continue;
+		
+		UVector<double> data(a.n0*a.n1*a.n2);
+		int id = 0;
+		for (int i0 = 0; i0 < a.n0; ++i0) 
+			for (int i1 = 0; i1 < a.n1; ++i1) 
+				for (int i2 = 0; i2 < a.n2; ++i2) 
+					data[id++] = a.Get(i0, i1, i2);
+		
+		hsize_t dims[3]  = {hsize_t(a.n0), hsize_t(a.n1), hsize_t(a.n2)};
+		hsize_t chunk[3] = {1, hsize_t(a.n1), hsize_t(a.n2)};	// Each chunk is a full row, as read by WEC-Sim
+		
+		hid_t space = H5Screate_simple(3, dims, NULL);
+		hid_t plist = H5Pcreate(H5P_DATASET_CREATE);
+		H5Pset_chunk(plist, 3, chunk);
+		H5Pset_shuffle(plist);
+		H5Pset_deflate(plist, 6);
+		
+		hid_t dset = H5Dcreate2(file, a.path, H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, plist, H5P_DEFAULT);
+		herr_t err = dset < 0 ? -1 : H5Dwrite(dset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.begin());
+		if (err >= 0 && !a.description.IsEmpty()) {
+			hid_t atype = H5Tcopy(H5T_C_S1);
+			H5Tset_size(atype, a.description.GetCount());
+			hid_t aspace = H5Screate(H5S_SCALAR);
+			hid_t attr = H5Acreate2(dset, "description", atype, aspace, H5P_DEFAULT, H5P_DEFAULT);
+			if (attr >= 0) {
+				H5Awrite(attr, atype, ~a.description);
+				H5Aclose(attr);
+			}
+			H5Sclose(aspace);
+			H5Tclose(atype);
+		}
+		if (dset >= 0)
+			H5Dclose(dset);
+		H5Pclose(plist);
+		H5Sclose(space);
+		if (err < 0) {
+			H5Fclose(file);
+			throw Exc(F(t_("Impossible to save '%s' in '%s'"), a.path, fileName));
+		}
+	}
+	H5Fclose(file);
+}
+
 void BemioH5::Save(String file) const {
 	String fileName = ForceExtSafer(file, ".h5");
 	
+	bool compressed = Bem().opH5Compressed;
+	UArray<BemioH5Array> arrays;
+	
 	Hdf5File hfile;
 	
 	hfile.Create(fileName);
@@ -374,31 +423,34 @@ void BemioH5::Save(String file) const {
 			hfile.UpGroup();	
 		}		
 	};
-	auto SaveAllA = [&](int ib) {
-		MultiDimMatrixRowMajor<double> d(6, dt.Nb*6, dt.Nf);
-		for (int r = 0; r < 6; ++r) {
-			for (int c = 0; c < 6*dt.Nb; ++c) 
-				for (int iw = 0; iw < dt.Nf; ++iw) {
-					if (dt.A[ib*6 + r][c].size() == dt.Nf) 
-						d(r, c, iw) = Nvl2(dt.A[ib*6 + r][c][iw], 0.);
-					else
-						d(r, c, iw) = 0;
-				}
+	// In compressed mode full arrays are left for SaveCompressed(), and components are not saved.
+	// Get has to capture by value, as it is called after leaving the caller
+	auto SaveArray = [&](String group, const char *name, int n0, int n1, int n2, 
+						 Function<double(int, int, int)> Get, String description) {
+		if (compressed) {
+			BemioH5Array &arr = arrays.Add();
+			arr.path = group + "/" + name;
+			arr.description = description;
+			arr.n0 = n0;
+			arr.n1 = n1;
+			arr.n2 = n2;
+			arr.Get = pick(Get);
+		} else {
+			MultiDimMatrixRowMajor<double> d(n0, n1, n2);
+			for (int i0 = 0; i0 < n0; ++i0) 
+				for (int i1 = 0; i1 < n1; ++i1) 
+					for (int i2 = 0; i2 < n2; ++i2) 
+						d(i0, i1, i2) = Get(i0, i1, i2);
+			hfile.Set(name, d).SetDescription(description);
 		}
-		hfile.Set("all", d).SetDescription("Radiation damping");
 	};
-	auto SaveAllB = [&](int ib) {
-		MultiDimMatrixRowMajor<double> d(6, dt.Nb*6, dt.Nf);
-		for (int r = 0; r < 6; ++r) {
-			for (int c = 0; c < 6*dt.Nb; ++c) 
-				for (int iw = 0; iw < dt.Nf; ++iw) {
-					if (dt.B[ib*6 + r][c].size() == dt.Nf) 
-						d(r, c, iw) = Nvl2(dt.B[ib*6 + r][c][iw], 0.);
-					else
-						d(r, c, iw) = 0;
-				}
-		}
-		hfile.Set("all", d).SetDescription("Radiation damping");
+	auto SaveAllAB = [&](const UArray<UArray<VectorXd>> &a, int ib, const char *group, String description) {
+		SaveArray(F("/body%d/hydro_coeffs/%s", ib+1, group), "all", 6, dt.Nb*6, dt.Nf, [&a, ib, Nf = dt.Nf](int r, int c, int iw)->double {
+			if (a[ib*6 + r][c].size() == Nf) 
+				return Nvl2(a[ib*6 + r][c][iw], 0.);
+			else
+				return 0;
+		}, description);
 	};
 		
 	auto SaveForce = [&](const Hydro::Forces &f, int ib, String caption) {
@@ -452,30 +504,18 @@ void BemioH5::Save(String file) const {
 			hfile.UpGroup();	
 		}
 	};
-	auto SaveForceAll = [&](const Hydro::Forces &f, int ib, String caption) {
-		MultiDimMatrixRowMajor<double> d_m(6, dt.Nh, dt.Nf), d_p(6, dt.Nh, dt.Nf), d_r(6, dt.Nh, dt.Nf), d_i(6, dt.Nh, dt.Nf);		
-		for (int idf = 0; idf < 6; ++idf) 
-			for (int ih = 0; ih < dt.Nh; ++ih) 
-				for (int iw = 0; iw < dt.Nf; ++iw) {
-					const std::complex<double> &n = Nvl2(f[ib][ih](iw, idf), std::complex(0.,0.));		
-					d_r(idf, ih, iw) = n.real();		
-					d_i(idf, ih, iw) = n.imag();		
-					d_m(idf, ih, iw) = abs(n);		
-					d_p(idf, ih, iw) = arg(n);		
-				}
-				
-		hfile.Set("re",    d_r).SetDescription(F("Real component of %s force", caption));		
-		hfile.Set("im",    d_i).SetDescription(F("Imaginary component of %s force", caption));
-		hfile.Set("mag",   d_m).SetDescription(F("Magnitude of %s force", caption));
-		hfile.Set("phase", d_p).SetDescription(F("Phase angle of %s force", caption));
+	auto SaveForceAll = [&](const Hydro::Forces &f, int ib, String group, String caption) {
+		auto Val = [&f, ib](int idf, int ih, int iw) {return Nvl2(f[ib][ih](iw, idf), std::complex(0.,0.));};
+		
+		SaveArray(group, "re",    6, dt.Nh, dt.Nf, [Val](int idf, int ih, int iw) {return Val(idf, ih, iw).real();}, F("Real component of %s force", caption));		
+		SaveArray(group, "im",    6, dt.Nh, dt.Nf, [Val](int idf, int ih, int iw) {return Val(idf, ih, iw).imag();}, F("Imaginary component of %s force", caption));
+		SaveArray(group, "mag",   6, dt.Nh, dt.Nf, [Val](int idf, int ih, int iw) {return abs(Val(idf, ih, iw));},   F("Magnitude of %s force", caption));
+		SaveArray(group, "phase", 6, dt.Nh, dt.Nf, [Val](int idf, int ih, int iw) {return arg(Val(idf, ih, iw));},   F("Phase angle of %s force", caption));
 	};
 	auto SaveMD = [&](int ib, String caption) {
-		MultiDimMatrixRowMajor<double> md(6, dt.Nh, dt.Nf);		
-		for (int idf = 0; idf < 6; ++idf) 
-			for (int ih = 0; ih < dt.Nh; ++ih) 
-				for (int iw = 0; iw < dt.Nf; ++iw)
-					md(idf, ih, iw) = Nvl2(dt.md[ib][ih][idf][iw], 0.);		
-		hfile.Set("val", md).SetDescription(F("Mean drift obtained with %s method", caption));		
+		SaveArray(F("/body%d/hydro_coeffs/mean_drift/%s", ib+1, caption), "val", 6, dt.Nh, dt.Nf, [this, ib](int idf, int ih, int iw) {
+			return Nvl2(dt.md[ib][ih][idf][iw], 0.);
+		}, F("Mean drift obtained with %s method", caption));		
 	};	
 	
 	for (int ib = 0; ib < dt.Nb; ++ib) {
@@ -517,34 +557,40 @@ void BemioH5::Save(String file) const {
 						hfile.Set("inf_freq", mat).SetDescription("Infinite frequency added mass").SetUnits("kg");
 					}
 					if (IsLoadedA()) {
-						SaveAllA(ib);
-						SaveComponentsA(ib);
+						SaveAllAB(dt.A, ib, "added_mass", "Added mass");
+						if (!compressed)
+							SaveComponentsA(ib);
 					}
 					hfile.UpGroup();	
 				}
 				if (hfile.CreateGroup("radiation_damping", true)) {
 					if (IsLoadedB()) {
-						SaveAllB(ib);
-						SaveComponentsB(ib);
+						SaveAllAB(dt.B, ib, "radiation_damping", "Radiation damping");
+						if (!compressed)
+							SaveComponentsB(ib);
 					}						
 					hfile.UpGroup();	
 				}
 				if (hfile.CreateGroup("excitation", true)) {
+					String group = F("/body%d/hydro_coeffs/excitation", ib+1);
 					if (IsLoadedFex()) {
-						SaveForceAll(dt.ex, ib, "excitation");
-						SaveForce(dt.ex, ib, "excitation");
+						SaveForceAll(dt.ex, ib, group, "excitation");
+						if (!compressed)
+							SaveForce(dt.ex, ib, "excitation");
 					}
 					if (hfile.CreateGroup("froude-krylov", true)) {
 						if (IsLoadedFfk()) {
-							SaveForceAll(dt.fk, ib, "froude-krylov");
-							SaveForce(dt.fk, ib, "froude-krylov");
+							SaveForceAll(dt.fk, ib, group + "/froude-krylov", "froude-krylov");
+							if (!compressed)
+								SaveForce(dt.fk, ib, "froude-krylov");
 						}
 						hfile.UpGroup();		
 					}
 					if (hfile.CreateGroup("scattering", true)) {
 						if (IsLoadedFsc()) {
-							SaveForceAll(dt.sc, ib, "scattering");
-							SaveForce(dt.sc, ib, "scattering");
+							SaveForceAll(dt.sc, ib, group + "/scattering", "scattering");
+							if (!compressed)
+								SaveForce(dt.sc, ib, "scattering");
 						}
 						hfile.UpGroup();	
 					}
@@ -579,4 +625,8 @@ void BemioH5::Save(String file) const {
 			hfile.UpGroup();
 		}
 	}
+	if (compressed) {
+		hfile.Close();
+		SaveCompressed(fileName, arrays);
+	}
 }
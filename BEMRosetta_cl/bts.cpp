@@ -39,17 +39,45 @@ void BTSWind::LoadBTSHeader(FileInBinary &file, VectorXf &Vslope, VectorXf &Voff
     description = str;
 }
 	              
-String BTSWind::LoadBTS(String fileName) {
+String BTSWind::LoadBTS(String fileName, bool stream) {
 	FileInBinary file(ForceExtSafer(fileName, ".bts"));
 	if (!file.IsOpen())
 		return t_("Impossible to load file");
 
 	this->fileName = fileName;
+	btsMap.Clear();
 
 	try {
 	    VectorXf Vslope(3), Voffset(3);
 	 	LoadBTSHeader(file, Vslope, Voffset);
 	
+		if (stream) {		// The body is not read. Values are decoded when needed
+			btsPos = file.GetPos();
+			int64 num = int64(nt)*3*(ny*nz + ntwr);
+			int64 sz = file.GetSize() - btsPos;
+			if (sz == 2*num)
+				btsSz = 2;
+			else if (sz == 4*num)
+				btsSz = 4;
+			else
+				return t_("Wrong format");
+			file.Close();
+			
+			btsMap.Create();
+			if (!btsMap->Open(ForceExtSafer(fileName, ".bts")) || !(btsData = btsMap->Map(0, size_t(btsMap->GetFileSize())))) {
+				btsMap.Clear();
+				return t_("Impossible to map file");
+			}
+			for (int k = 0; k < 3; ++k) {
+				btsSlope[k] = Vslope(k);
+				btsOffset[k] = Voffset(k);
+			}
+			velocity = Tensor<float, 4>();
+			twrVelocity = Tensor<float, 3>();
+			nffc = 3;
+			return String();
+		}
+		
 		String ret;
 		int64 pos = file.GetPos();
 		if (!IsEmpty(ret = LoadBTSBody<float>(file, Vslope, Voffset))) {// Try with float
@@ -63,6 +91,49 @@ String BTSWind::LoadBTS(String fileName) {
 	}
 }
 
+// Per component minimum and maximum of grid and tower velocities, reduced in parallel
+void BTSWind::GetRange(VectorXd &mn, VectorXd &mx) const {
+	mn = VectorXd::Constant(3, std::numeric_limits<double>::max());
+	mx = VectorXd::Constant(3, std::numeric_limits<double>::lowest());
+	if (IsNull(nt) || nt <= 0)
+		return;
+	
+	Mutex mutex;
+	CoPartition(0, nz, [&](int iz0, int iz1) {
+		double pmn[3], pmx[3];
+		for (int k = 0; k < 3; ++k) {
+			pmn[k] = std::numeric_limits<double>::max();
+			pmx[k] = std::numeric_limits<double>::lowest();
+		}
+		for (int iz = iz0; iz < iz1; ++iz) 
+			for (int iy = 0; iy < ny; ++iy) 
+				for (int k = 0; k < 3; ++k) {
+					if (IsStreamed()) {
+						for (int it = 0; it < nt; ++it) {
+							double v = Vel(it, k, iy, iz);
+							pmn[k] = std::min(v, pmn[k]);
+							pmx[k] = std::max(v, pmx[k]);
+						}
+					} else {
+						Map<const ArrayXf> v(&velocity(0, k, iy, iz), nt);
+						pmn[k] = std::min(double(v.minCoeff()), pmn[k]);
+						pmx[k] = std::max(double(v.maxCoeff()), pmx[k]);
+					}
+				}
+		Mutex::Lock __(mutex);
+		for (int k = 0; k < 3; ++k) {
+			mn(k) = std::min(pmn[k], mn(k));
+			mx(k) = std::max(pmx[k], mx(k));
+		}
+	});
+	for (int itw = 0; itw < ntwr; ++itw) 
+		for (int k = 0; k < 3; ++k) 
+			for (int it = 0; it < nt; ++it) {
+				mx(k) = std::max(double(TwrVel(it, k, itw)), mx(k));     
+				mn(k) = std::min(double(TwrVel(it, k, itw)), mn(k));     
+			}
+}
+
 void BTSWind::SaveBTSHeader(FileOutBinary &file, VectorXf &Vslope, VectorXf &Voffset, int fmtSz) const {
     file.Write(int16(turbSimFormat));  
 
@@ -78,24 +149,8 @@ void BTSWind::SaveBTSHeader(FileOutBinary &file, VectorXf &Vslope, VectorXf &Vof
     file.Write(float(zHub));    // height of the hub, 						REAL(4), in m
     file.Write(float(zGrid));   // height of the bottom of the grid, 		REAL(4), in m
 
-    VectorXd mn = VectorXd::Constant(3, std::numeric_limits<double>::max());
-    VectorXd mx = VectorXd::Constant(3, std::numeric_limits<double>::lowest());
-    for (int it = 0; it < nt; ++it) {
-		for (int iz = 0; iz < nz; ++iz)
-			for (int iy = 0; iy < ny; ++iy)
-				for (int k = 0; k < 3; ++k) {
-                    mx(k) = std::max(velocity(it,k,iy,iz), mx(k));
-                    mn(k) = std::min(velocity(it,k,iy,iz), mn(k));
-                }
-			
-		if (ntwr > 0) {
-            for (int k = 0; k < 3; ++k)      // scale the data
-                for (int itw = 0; itw < ntwr; ++itw) {
-                	mx(k) = std::max(twrVelocity(it,k,itw), mx(k));     
-                	mn(k) = std::min(twrVelocity(it,k,itw), mn(k));     
-                }
-		}
-    }
+    VectorXd mn, mx;
+    GetRange(mn, mx);
     float maxType, minType;
     if (fmtSz == 2) {
         maxType = std::numeric_limits<int16>::max();
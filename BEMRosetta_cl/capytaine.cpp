@@ -5,6 +5,46 @@
 #include <NetCDF/NetCDF.h>
 
 
+// Reads NetCDF variables by hyperslabs, so that the full array is never in memory
+class NetCDFSlab {
+public:
+	NetCDFSlab(const char *file) {
+		if (nc_open(file, NC_NOWRITE, &ncid) != NC_NOERR)
+			throw Exc(F(t_("Impossible to open '%s'"), file));
+	}
+	~NetCDFSlab() {
+		nc_close(ncid);
+	}
+	
+	// Reads var[irho][ih][re/im][idw][0..n4-1][0..n5-1], where the rho and h axes may not exist
+	void GetFrequency(const char *var, bool isrho, bool ish, int irho, int ih, int idw, int n4, int n5, UVector<double> &data) {
+		int varid;
+		if (nc_inq_varid(ncid, var, &varid) != NC_NOERR)
+			throw Exc(F(t_("Variable '%s' not found"), var));
+		
+		size_t start[6], count[6];
+		int id = 0;
+		if (isrho) {
+			start[id] = irho;	count[id++] = 1;
+		}
+		if (ish) {
+			start[id] = ih;		count[id++] = 1;
+		}
+		start[id] = 0;			count[id++] = 2;
+		start[id] = idw;		count[id++] = 1;
+		start[id] = 0;			count[id++] = n4;
+		start[id] = 0;			count[id++] = n5;
+		
+		data.SetCount(2*n4*n5);
+		int ret = nc_get_vara_double(ncid, varid, start, count, data.begin());
+		if (ret != NC_NOERR)
+			throw Exc(F(t_("Error reading '%s': %s"), var, nc_strerror(ret)));
+	}
+	
+private:
+	int ncid = -1;
+};
+
 String CapyNC_Load(const char *file, UArray<Hydro> &hydros, int &num) {
 	num = 0;
 	
@@ -218,7 +258,6 @@ String CapyNC_Load(const char *file, UArray<Hydro> &hydros, int &num) {
 		}
 				
 		MultiDimMatrixRowMajor<double> pan;
-		MultiDimMatrixRowMajor<double> rad_press, dif_press, inc_press;
 
 		if (cdf.ExistVar("mesh_vertices")) {
 			cdf.GetDouble("mesh_vertices", pan);
@@ -229,44 +268,28 @@ String CapyNC_Load(const char *file, UArray<Hydro> &hydros, int &num) {
 			if (!(pan.size(1) == 4 && pan.size(2) == 3))
 				throw Exc(t_("Wrong dimension in mesh_vertices 2"));
 		}
-		if (cdf.ExistVar("radiation_pressure")) {
-			cdf.GetDouble("radiation_pressure", rad_press);
-			if (!(numaxisF == rad_press.GetNumAxis()))
-				throw Exc(t_("Wrong dimension in radiation_pressure"));		
-
-			if (_rho.size() == 1)  		// Added to simplify handling later
-				rad_press.InsertAxis(0, 1);
-			if (_h.size() == 1) 
-				rad_press.InsertAxis(1, 1);
-		
-			if (!(rad_press.size(2) == 2 && rad_press.size(3) == Nftotal && rad_press.size(4) == 6*Nb && rad_press.size(5) == numPan))
-				throw Exc(t_("Wrong dimension in radiation_pressure 2"));
-		}
-		if (cdf.ExistVar("diffraction_pressure")) {
-			cdf.GetDouble("diffraction_pressure", dif_press);
-			if (!(numaxisF == dif_press.GetNumAxis()))
-				throw Exc(t_("Wrong dimension in diffraction_pressure"));		
-		
-			if (_rho.size() == 1) 		// Added to simplify handling later
-				dif_press.InsertAxis(0, 1);
-			if (_h.size() == 1) 
-				dif_press.InsertAxis(1, 1);
-			
-			if (!(dif_press.size(2) == 2 && dif_press.size(3) == Nftotal && dif_press.size(4) == Nh && dif_press.size(5) == numPan))
-				throw Exc(t_("Wrong dimension in diffraction_pressure 2"));
-		}
-		if (cdf.ExistVar("incident_pressure")) {
-			cdf.GetDouble("incident_pressure", inc_press);
-			if (!(numaxisF == inc_press.GetNumAxis()))
-				throw Exc(t_("Wrong dimension in incident_pressure"));		
-		
-			if (_rho.size() == 1) 		// Added to simplify handling later
-				inc_press.InsertAxis(0, 1);				
-			if (_h.size() == 1) 
-				inc_press.InsertAxis(1, 1);
-			if (!(inc_press.size(2) == 2 && inc_press.size(3) == Nftotal && inc_press.size(4) == Nh && inc_press.size(5) == numPan))
-				throw Exc(t_("Wrong dimension in incident_pressure 2"));
-		}
+		// Panel pressures can be huge, so they are not loaded here but later by frequency hyperslabs
+		auto CheckPressure = [&](const char *var, int n4) {
+			if (!cdf.ExistVar(var))
+				return false;
+			nc_type type;
+			UVector<int> dims;
+			cdf.GetVariableData(var, type, dims);
+			if (!(numaxisF == dims.size()))
+				throw Exc(F(t_("Wrong dimension in %s"), var));
+			int id = dims.size() - 4;
+			if (!(dims[id] == 2 && dims[id+1] == Nftotal && dims[id+2] == n4 && dims[id+3] == numPan))
+				throw Exc(F(t_("Wrong dimension in %s 2"), var));
+			return true;
+		};
+		bool isRadPress = CheckPressure("radiation_pressure", 6*Nb);
+		bool isDifPress = CheckPressure("diffraction_pressure", Nh);
+		bool isIncPress = CheckPressure("incident_pressure", Nh);
+		
+		One<NetCDFSlab> slab;
+		if (isRadPress || isDifPress || isIncPress)
+			slab.Create(file);
+		UVector<double> press;
 
 		auto LoadAB = [&](const MultiDimMatrixRowMajor<double> &_a, UArray<UArray<VectorXd>> &a, int irho, int ih) {
 			int iwdelta = !thereisw0 ? 0 : 1;
@@ -396,54 +419,45 @@ String CapyNC_Load(const char *file, UArray<Hydro> &hydros, int &num) {
 				
 				int iwdelta = !thereisw0 ? 0 : 1;
 				
-				if (rad_press.size() > 0) {
+				if (isRadPress) {
 					hy.Initialize_PotsRad();
 					
-					for (int ipall = 0; ipall < numPan; ++ipall) {
-						int ib = bodyPan[ipall];
-						int ip = bodyIdEachPan[ipall];
-						for (int ifr = 0; ifr < Nf; ++ifr) {
-							double rw = hy.dt.rho*sqr(hy.dt.w[ifr]);							
+					int ndf = 6*Nb;
+					for (int ifr = 0; ifr < Nf; ++ifr) {
+						slab->GetFrequency("radiation_pressure", _rho.size() > 1, _h.size() > 1, irho, ih, ifr + iwdelta, ndf, numPan, press);
+						double rw = hy.dt.rho*sqr(hy.dt.w[ifr]);
+						for (int ipall = 0; ipall < numPan; ++ipall) {
+							int ib = bodyPan[ipall];
+							int ip = bodyIdEachPan[ipall];
 							for (int idf = 0; idf < 6; ++idf) {
-								double re = rad_press(irho, ih, 0, ifr + iwdelta, idf + 6*ib, ipall);
-								double im = rad_press(irho, ih, 1, ifr + iwdelta, idf + 6*ib, ipall);
+								double re = press[(0*ndf + idf + 6*ib)*numPan + ipall];
+								double im = press[(1*ndf + idf + 6*ib)*numPan + ipall];
 								hy.dt.pots_rad[ib][ip][idf][ifr] += std::complex<double>(-re, im)/rw; // p = -iρωΦ ; Φ = [Im(p) - iRe(p)]/ρω
 							}
 						}
 					}
 				}
-				if (inc_press.size() > 0) {
-					hy.Initialize_PotsIncDiff(hy.dt.pots_inc);
-					
-					for (int ipall = 0; ipall < numPan; ++ipall) {
-						int ib = bodyPan[ipall];
-						int ip = bodyIdEachPan[ipall];
-						for (int ifr = 0; ifr < Nf; ++ifr) {
-							double rw = hy.dt.rho*hy.dt.w[ifr];
-							for (int ihead = 0; ihead < Nh; ++ihead) {
-								double re = inc_press(irho, ih, 0, ifr + iwdelta, ihead, ipall);
-								double im = inc_press(irho, ih, 1, ifr + iwdelta, ihead, ipall);
-								hy.dt.pots_inc[ib][ip][ihead][ifr] += std::complex<double>(im, re)/rw; // p = -iρωΦ ; Φ = [Im(p) - iRe(p)]/ρω
-							}
-						}
-					}
-				}
-				if (dif_press.size() > 0) {
-					hy.Initialize_PotsIncDiff(hy.dt.pots_dif);
+				auto LoadPotsIncDiff = [&](const char *var, UArray<UArray<UArray<UArray<std::complex<double>>>>> &pots) {
+					hy.Initialize_PotsIncDiff(pots);
 					
-					for (int ipall = 0; ipall < numPan; ++ipall) {
-						int ib = bodyPan[ipall];
-						int ip = bodyIdEachPan[ipall];
-						for (int ifr = 0; ifr < Nf; ++ifr) {
-							double rw = hy.dt.rho*hy.dt.w[ifr];
+					for (int ifr = 0; ifr < Nf; ++ifr) {
+						slab->GetFrequency(var, _rho.size() > 1, _h.size() > 1, irho, ih, ifr + iwdelta, Nh, numPan, press);
+						double rw = hy.dt.rho*hy.dt.w[ifr];
+						for (int ipall = 0; ipall < numPan; ++ipall) {
+							int ib = bodyPan[ipall];
+							int ip = bodyIdEachPan[ipall];
 							for (int ihead = 0; ihead < Nh; ++ihead) {
-								double re = dif_press(irho, ih, 0, ifr + iwdelta, ihead, ipall);
-								double im = dif_press(irho, ih, 1, ifr + iwdelta, ihead, ipall);
-								hy.dt.pots_dif[ib][ip][ihead][ifr] += std::complex<double>(im, re)/rw; // p = -iρωΦ ; Φ = [Im(p) - iRe(p)]/ρω
+								double re = press[(0*Nh + ihead)*numPan + ipall];
+								double im = press[(1*Nh + ihead)*numPan + ipall];
+								pots[ib][ip][ihead][ifr] += std::complex<double>(im, re)/rw; // p = -iρωΦ ; Φ = [Im(p) - iRe(p)]/ρω
 							}
 						}
 					}
-				}
+				};
+				if (isIncPress) 
+					LoadPotsIncDiff("incident_pressure", hy.dt.pots_inc);
+				if (isDifPress) 
+					LoadPotsIncDiff("diffraction_pressure", hy.dt.pots_dif);
 			}
 		}
 	} catch (Exc e) {
@@ -84,6 +84,37 @@ L_EXPORT void BMR_AQWA_ShowCalculationDialog_Set(int show) noexcept {
 	BMR().errorStr.Clear();
 }
 
+void BMR_BEMIO_Compressed_Set(int compressed) noexcept {
+	try {
+		Bem().opH5Compressed = compressed;
+	} catch(Exc err) {
+		BMR().errorStr = err;
+		return;
+	}
+	BMR().errorStr.Clear();
+}
+
+void BMR_Cache_Set(int cache) noexcept {
+	try {
+		Bem().opCache = cache;
+	} catch(Exc err) {
+		BMR().errorStr = err;
+		return;
+	}
+	BMR().errorStr.Clear();
+}
+
+void BMR_Cache_Clear() noexcept {
+	try {
+		if (!Bem().ClearCache())
+			throw Exc(F(t_("Impossible to clear cache folder '%s'"), Bem().GetCacheFolder()));
+	} catch(Exc err) {
+		BMR().errorStr = err;
+		return;
+	}
+	BMR().errorStr.Clear();
+}
+
 int BMR_Mesh_Load(const char *file) noexcept {
 	try {
 		if (!FileExists(file))
@@ -973,6 +1004,19 @@ void BMR_Bem_Body_Name_Set(const char *name) noexcept {
 	BMR().errorStr.Clear();
 }
 
+void BMR_Bem_SaveCase_Balance_Set(int balance, const char *profile) noexcept {
+	try {
+		if (profile && *profile && !FileExists(profile))
+			throw Exc(F(t_("File '%s' not found"), profile));
+		Bem().opCaseBalance = balance;
+		Bem().caseProfile = profile ? profile : "";
+	} catch(Exc err) {
+		BMR().errorStr = err;
+		return;
+	}
+	BMR().errorStr.Clear();
+}
+
 void BMR_Bem_SaveCase(const char *folder, const char *solver, bool x0z, bool y0z, 
 		bool irregular, bool autoIrregular, const char *qtfType, bool autoQTF, 
 		bool bin, int numCases, int numThreads, bool withPotentials, bool withMesh) noexcept {
@@ -1286,6 +1330,73 @@ const char *BMR_FAST_GetVar(const char *name, const char *paragraph) noexcept {
 	return ret;
 }
 
+int BMR_Wind_Load(const char *file) noexcept {
+	try {
+		if (!FileExists(file))
+			throw Exc(F(t_("File '%s' not found"), file)); 
+		
+		Wind &w = BMR().wind.Add();
+		String ret = w.Load(file, "");
+		if (!ret.IsEmpty()) {
+			BMR().wind.Drop();
+			throw Exc(ret);
+		}
+		BMR().windid = BMR().wind.size() - 1;
+	} catch(Exc err) {
+		BMR().errorStr = err;
+		return -1;
+	}
+	BMR().errorStr.Clear();
+	return BMR().windid;
+}
+
+void BMR_Wind_Clear() noexcept {
+	BMR().wind.Clear();
+	BMR().windid = -1;
+}
+
+static void BMR_Wind_Return(const MatrixXd &v, double **data, int dim[2]) {
+	static UVector<double> d;
+	dim[0] = (int)v.rows();
+	dim[1] = (int)v.cols();
+	CopyRowMajor(v, d);
+	*data = d.begin();
+}
+
+void BMR_Wind_Interpolate(int ic, const double *y, const double *z, int np, const double *time, int nt, double **data, int dim[2]) noexcept {
+	try {
+		if (BMR().wind.IsEmpty()) 
+			throw Exc(t_("No file loaded"));
+		if (ic < -1 || ic > 2)
+			throw Exc(F(t_("Invalid component %d"), ic));
+		VectorXd vy = Map<const VectorXd>(y, np), 
+				 vz = Map<const VectorXd>(z, np), 
+				 vt = Map<const VectorXd>(time, nt);
+		BMR_Wind_Return(BMR().wind[BMR().windid].Interpolate(ic, vy, vz, vt), data, dim);
+	} catch(Exc err) {
+		BMR().errorStr = err;
+		return;
+	}
+	BMR().errorStr.Clear();
+}
+
+void BMR_Wind_RotorEquivalent(const double *y, const double *z, const double *radius, const double *yaw, int np, const double *time, int nt, double **data, int dim[2]) noexcept {
+	try {
+		if (BMR().wind.IsEmpty()) 
+			throw Exc(t_("No file loaded"));
+		VectorXd vy = Map<const VectorXd>(y, np), 
+				 vz = Map<const VectorXd>(z, np), 
+				 vr = Map<const VectorXd>(radius, np), 
+				 vyaw = Map<const VectorXd>(yaw, np), 
+				 vt = Map<const VectorXd>(time, nt);
+		BMR_Wind_Return(BMR().wind[BMR().windid].GetRotorEquivalent(vy, vz, vr, vyaw, vt), data, dim);
+	} catch(Exc err) {
+		BMR().errorStr = err;
+		return;
+	}
+	BMR().errorStr.Clear();
+}
+
 double BMR_DemoVectorPyC(const double *v, int num) noexcept {
     double res = 0;
     for (int i = 0; i < num; ++i) 
@@ -24,6 +24,12 @@ extern "C" {
 	L_EXPORT void BMR_Wamit_V6s_Set(int force) noexcept;
 	// Show the calculation dialog when running AQWA
 	L_EXPORT void BMR_AQWA_ShowCalculationDialog_Set(int show) noexcept;
+	// Save BEMIO .h5 full arrays chunked and compressed, without the per component datasets
+	L_EXPORT void BMR_BEMIO_Compressed_Set(int compressed) noexcept;
+	// Reuse Kirf, A∞, A∞(ω) and potentials data from the cache when loading the same files
+	L_EXPORT void BMR_Cache_Set(int cache) noexcept;
+	// Delete all cache entries
+	L_EXPORT void BMR_Cache_Clear() noexcept;
 		
 	// Clear all meshes previously loaded	
 	L_EXPORT void BMR_Mesh_Clear() noexcept;
@@ -111,6 +117,8 @@ extern "C" {
 	L_EXPORT void BMR_Bem_headings_Set(const double *head, int dim) noexcept;
 	// Copies a Bem case into other
 	L_EXPORT int BMR_Bem_Duplicate() noexcept;
+	// Split cases in BMR_Bem_SaveCase() balancing their predicted load, optionally with a frequency, time profile of a previous run
+	L_EXPORT void BMR_Bem_SaveCase_Balance_Set(int balance, const char *profile) noexcept;
 	// Saves the Bem case
 	L_EXPORT void BMR_Bem_SaveCase(const char *folder, const char *solver, bool x0z, bool y0z, bool irregular, bool autoIrregular, const char *qtfType, bool autoQTF, bool bin, int numCases, int numThreads, bool withPotentials, bool withMesh) noexcept;
 	
@@ -180,5 +188,15 @@ extern "C" {
 	L_EXPORT int BMR_FAST_SetVar(const char *name, const char *paragraph, const char *value) noexcept;
 	// Reads the value of a var after paragraph. If paragraph is "", it is read the first time var appears in the file
 	L_EXPORT const char *BMR_FAST_GetVar(const char *name, const char *paragraph) noexcept;
+	
+	// Loads a wind file (.bts, .wnd, ...) and sets it as the active one
+	L_EXPORT int BMR_Wind_Load(const char *file) noexcept;
+	// Clear all wind files previously loaded
+	L_EXPORT void BMR_Wind_Clear() noexcept;
+	// Returns the np x nt matrix of the velocity component ic (0 u, 1 v, 2 w, -1 norm) bilinearly interpolated at points y, z 
+	// and times time. If nt is 0 all the time steps are returned
+	L_EXPORT void BMR_Wind_Interpolate(int ic, const double *y, const double *z, int np, const double *time, int nt, double **data, int dim[2]) noexcept;
+	// Returns the np x nt matrix of the rotor equivalent wind speed of np rotors centred at y, z, with radius and yaw [deg]
+	L_EXPORT void BMR_Wind_RotorEquivalent(const double *y, const double *z, const double *radius, const double *yaw, int np, const double *time, int nt, double **data, int dim[2]) noexcept;
 };
 
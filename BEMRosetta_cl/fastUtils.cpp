@@ -3,6 +3,8 @@
 #include "BEMRosetta.h"
 #include "BEMRosetta_int.h"
 #include <random>
+#include <atomic>
+#include <filesystem>
 
 String GetSpaces(int num) {
 	ASSERT(num >= 0);
@@ -56,28 +58,32 @@ bool GetFASTVarLine(const String &strFile, String varName, String paragraph, int
 	return true;
 }
 
+// Text that replaces the value sactual, before the variable name
+static String GetFASTValue(String sactual, const String &value) {
+	sactual.Replace("\t", "    ");
+	int posEndValue;
+	for (posEndValue = sactual.GetCount()-1; posEndValue >= 0; --posEndValue)
+		if (!IsSpace(sactual[posEndValue]))
+			break;
+	
+	int nright, nleft;
+	if (posEndValue+1 >= value.GetCount()) {		// Value added maintaining right margin
+		nright = sactual.GetCount() - posEndValue - 1;
+		nleft = sactual.GetCount() - nright - value.GetCount();
+	} else if (sactual.GetCount()-1 > value.GetCount()) {// Value added maintaining varname position
+		int navail = sactual.GetCount() - value.GetCount();	
+		nleft = 0;									// Values tend to be at the left
+		nright = navail - nleft;
+	} else 											// Value added moving all
+		nright = nleft = 1;
+	
+	return GetSpaces(nleft) + value + GetSpaces(nright);
+}
+
 void SetFASTVar(String &strFile, String varName, String value, String paragraph) {
 	int posIni, pos, pos0 = 0;
 	while (GetFASTVarLine(strFile, varName, paragraph, posIni, pos, pos0)) {
-		String sactual = strFile.Mid(posIni, pos - posIni);
-		sactual.Replace("\t", "    ");
-		int posEndValue;
-		for (posEndValue = sactual.GetCount()-1; posEndValue >= 0; --posEndValue)
-			if (!IsSpace(sactual[posEndValue]))
-				break;
-		
-		int nright, nleft;
-		if (posEndValue+1 >= value.GetCount()) {		// Value added maintaining right margin
-			nright = sactual.GetCount() - posEndValue - 1;
-			nleft = sactual.GetCount() - nright - value.GetCount();
-		} else if (sactual.GetCount()-1 > value.GetCount()) {// Value added maintaining varname position
-			int navail = sactual.GetCount() - value.GetCount();	
-			nleft = 0;									// Values tend to be at the left
-			nright = navail - nleft;
-		} else 											// Value added moving all
-			nright = nleft = 1;
-
-		strFile = strFile.Left(posIni) + GetSpaces(nleft) + value + GetSpaces(nright) + strFile.Mid(pos);
+		strFile = strFile.Left(posIni) + GetFASTValue(strFile.Mid(posIni, pos - posIni), value) + strFile.Mid(pos);
 
 		pos0 = pos + varName.GetCount();
 	}
@@ -168,3 +174,457 @@ UVector<UVector<String>> GetFASTArray(const String &strFile, String var, String
 	}
 	return ret;
 }
+
+void FASTCase::File::SetText(const String &text) {
+	lines.Clear();
+	index.Clear();
+	lineIndex.Clear();
+	paragraphs.Clear();
+	if (text.IsEmpty())
+		return;
+	
+	for (int pos0 = 0;;) {
+		int pos = text.Find('\n', pos0);
+		if (pos < 0) {
+			lines << text.Mid(pos0);
+			break;
+		}
+		lines << text.Mid(pos0, pos - pos0);
+		pos0 = pos + 1;
+	}
+	lineIndex.SetCount(lines.size());
+	for (int il = 0; il < lines.size(); ++il)
+		IndexLine(il);
+}
+
+String FASTCase::File::GetText() const {
+	return Join(lines, "\n");
+}
+
+// The tokens that GetFASTVarLine() accepts as names: the first two, and the ones after a quoted text.
+// They have to be followed by a space, so the last token of the text is not valid
+void FASTCase::File::IndexLine(int il) {
+	const String &line = lines[il];
+	bool last = il == lines.size() - 1;
+	UVector<int> &ids = lineIndex[il];
+	ids.Clear();
+	
+	int len = line.GetCount();
+	int pos = 0;
+	bool beginQuote = false, endQuote = false;
+	for (int k = 0; ; ++k) {
+		while (pos < len && IsSpace(line[pos]))
+			pos++;
+		if (pos == len)
+			break;
+		int pos0 = pos;
+		while (pos < len && !IsSpace(line[pos]))
+			pos++;
+		if (k == 0)
+			beginQuote = line[pos0] == '"';
+		if ((k <= 1 || (beginQuote && endQuote)) && !(pos == len && last)) {
+			Pos p(il, pos0);
+			int id = index.FindAdd(line.Mid(pos0, pos - pos0));
+			UVector<Pos> &v = index[id];
+			v.Insert(int(std::upper_bound(v.begin(), v.end(), p) - v.begin()), p);
+			ids << id;
+		}
+		if (k >= 1 && !beginQuote)
+			break;					// Without quotes only the first two tokens are valid
+		endQuote = line[pos-1] == '"';
+	}
+}
+
+void FASTCase::File::UnindexLine(int il) {
+	for (int id : lineIndex[il]) {
+		UVector<Pos> &v = index[id];
+		int i = int(std::lower_bound(v.begin(), v.end(), Pos(il, -1)) - v.begin());
+		int j = i;
+		while (j < v.size() && v[j].line == il)
+			j++;
+		v.Remove(i, j - i);
+	}
+	lineIndex[il].Clear();
+}
+
+void FASTCase::File::ChangeLine(int il, const String &line) {
+	UnindexLine(il);
+	lines[il] = line;
+	IndexLine(il);
+	
+	for (int ip = 0; ip < paragraphs.size(); ++ip) {
+		const String &paragraph = paragraphs.GetKey(ip);
+		UVector<Pos> &v = paragraphs[ip];
+		int i = int(std::lower_bound(v.begin(), v.end(), Pos(il, -1)) - v.begin());
+		int j = i;
+		while (j < v.size() && v[j].line == il)
+			j++;
+		v.Remove(i, j - i);
+		for (int pos = line.Find(paragraph); pos >= 0; pos = line.Find(paragraph, pos + 1))
+			v.Insert(i++, Pos(il, pos));
+	}
+}
+
+FASTCase::File::Pos FASTCase::File::FindParagraph(const String &paragraph, Pos from) {
+	ASSERT(paragraph.Find('\n') < 0);
+	
+	int ip = paragraphs.Find(paragraph);
+	if (ip < 0) {
+		ip = paragraphs.GetCount();
+		UVector<Pos> &v = paragraphs.Add(paragraph);
+		for (int il = 0; il < lines.size(); ++il)
+			for (int pos = lines[il].Find(paragraph); pos >= 0; pos = lines[il].Find(paragraph, pos + 1))
+				v << Pos(il, pos);
+	}
+	const UVector<Pos> &v = paragraphs[ip];
+	int i = int(std::lower_bound(v.begin(), v.end(), from) - v.begin());
+	if (i == v.size())
+		return Pos();
+	return Pos(v[i].line, v[i].col + paragraph.GetCount());		// As FindAfter()
+}
+
+FASTCase::File::Pos FASTCase::File::FindVar(const String &var, const String &paragraph, Pos from) {
+	if (!paragraph.IsEmpty()) {
+		from = FindParagraph(paragraph, from);
+		if (from.line < 0)
+			return Pos();
+	}
+	int id = index.Find(var);
+	if (id < 0)
+		return Pos();
+	const UVector<Pos> &v = index[id];
+	int i = int(std::lower_bound(v.begin(), v.end(), from) - v.begin());
+	if (i == v.size())
+		return Pos();
+	return v[i];
+}
+
+void FASTCase::File::SetVar(const String &var, const String &value, const String &paragraph) {
+	Pos from(0, 0);
+	while (true) {
+		Pos p = FindVar(var, paragraph, from);
+		if (p.line < 0)
+			break;
+		const String &line = lines[p.line];
+		ChangeLine(p.line, GetFASTValue(line.Left(p.col), value) + line.Mid(p.col));
+		from = Pos(p.line, p.col + var.GetCount());		// As SetFASTVar(), from the old position
+	}
+}
+
+void FASTCase::File::SetMatrixVal(String var, int row, int col, double val) {
+	if (!IsAvailable()) 
+		throw Exc(F(t_("Impossible to read file '%s'"), fileName));
+	
+	int il;
+	for (il = 0; il < lines.size(); ++il)
+		if (lines[il].Find(var) >= 0)
+			break;
+	if (il == lines.size())
+		throw Exc(F(t_("Wrong variable '%s' in GetMatrixIds"), var));
+	if (il == 0)
+		throw Exc(F(t_("Problem reading variable '%s' in GetMatrixIds"), var));
+	il += row;
+	if (il >= lines.size())
+		throw Exc(F(t_("Problem reading variable '%s' row %d in GetMatrixIds"), var, row));
+	
+	const String &line = lines[il];
+	int id = 0, posIni = 0, posEnd = 0;
+	for (int ic = 0; ic <= col; ++ic) {
+		posIni = id;
+		while (id < line.GetCount() && IsSpace(line[id]))
+			id++;
+		if (id == line.GetCount()) {		// The row continues in the next line. The full text is processed
+			String text = GetText();
+			GetFASTMatrixIds(text, var, row, col, posIni, posEnd);
+			SetText(text.Left(posIni) + F(" ") + FDS(val, posEnd-posIni-1, true) + text.Mid(posEnd));
+			isChanged = true;
+			return;
+		}
+		while (id < line.GetCount() && !IsSpace(line[id]))
+			id++;
+		posEnd = id;
+	}
+	ChangeLine(il, line.Left(posIni) + F(" ") + FDS(val, posEnd-posIni-1, true) + line.Mid(posEnd));
+	isChanged = true;
+}
+
+String FASTCase::BenchmarkCases(String file, int numCases, int &numEqual) {
+	String seed = LoadFile(file);
+	if (seed.IsEmpty())
+		throw Exc(F(t_("Impossible to read file '%s'"), file));
+	
+	// About the variables changed in a HydroDyn file by a DLC case
+	const UVector<String> vars = {"WtrDens", "WtrDpth", "WaveMod", "WaveTMax", "WaveDT", "WAVES/WaveHs", "WAVES/WaveTp", 
+		"WvLowCOff", "WvHiCOff", "WaveDir", "WaveDirSpread", "WaveSeed(1)", "WaveSeed(2)", "WvLowCOffD", "WvHiCOffD", 
+		"CURRENT/CurrMod", "CurrSSV0", "CurrNSRef", "CurrNSV0", "CurrNSDir", "CurrDIV", "CurrDIDir", "WAMITULEN", 
+		"PtfmCOBxt", "PtfmCOByt", "RdtnTMax", "MnDrift", "NewmanApp", "DiffQTF", "SumQTF"};
+	auto GetVal = [](int ic, int iv) {return 1 + iv + 0.001*ic;};
+	
+	TimeStop t;
+	UVector<String> texts(numCases);
+	for (int ic = 0; ic < numCases; ++ic) {
+		String &text = texts[ic];
+		text = seed;
+		for (int iv = 0; iv < vars.size(); ++iv) {
+			UVector<String> name = Split(vars[iv], "/");
+			SetFASTVar(text, name.Top(), FDS(GetVal(ic, iv), 10), name.size() == 2 ? name[0] : String());
+		}
+	}
+	double tText = t.Seconds();
+	
+	t.Reset();
+	numEqual = 0;
+	for (int ic = 0; ic < numCases; ++ic) {
+		File f;
+		f.SetText(seed);
+		for (int iv = 0; iv < vars.size(); ++iv) 
+			f.SetDouble(vars[iv], GetVal(ic, iv));
+		if (f.GetText() == texts[ic])
+			numEqual++;
+	}
+	double tFile = t.Seconds();
+	
+	String ret;
+	ret << F(t_("%d cases setting %d variables in '%s'"), numCases, vars.size(), GetFileName(file));
+	ret << "\n" << F(t_("Full text: %.3f s, %.1f cases/s"), tText, numCases/max(tText, 1E-9));
+	ret << "\n" << F(t_("Indexed:   %.3f s, %.1f cases/s"), tFile, numCases/max(tFile, 1E-9));
+	ret << "\n" << F(t_("Identical files: %d"), numEqual);
+	return ret;
+}
+
+const char *FASTCaseMatrix::fileTypes[] = {"fast", "elastodyn", "hydrodyn", "inflowfile", "subdyn"};
+
+FASTCase::File &FASTCaseMatrix::GetFile(FASTCase &cas, int idFile) {
+	switch (idFile) {
+	case 0:		return cas.fast;
+	case 1:		return cas.elastodyn;
+	case 2:		return cas.hydrodyn;
+	case 3:		return cas.inflowfile;
+	default:	return cas.subdyn;
+	}
+}
+
+void FASTCaseMatrix::AddVar(String var, String values) {
+	int pos = var.Find(':');
+	if (pos < 0)
+		throw Exc(F(t_("Wrong variable '%s'. The format is <file>:<variable>"), var));
+	String type = ToLower(Trim(var.Left(pos)));
+	int idFile = -1;
+	for (int i = 0; i < __countof(fileTypes); ++i)
+		if (type == fileTypes[i])
+			idFile = i;
+	if (idFile < 0)
+		throw Exc(F(t_("Unknown file '%s' in variable '%s'"), type, var));
+	
+	Var &v = vars.Add();
+	v.idFile = idFile;
+	v.name = Trim(var.Mid(pos+1));
+	v.values = Split(values, ',');
+	for (String &val : v.values)
+		val = Trim(val);
+	if (v.name.IsEmpty() || v.values.IsEmpty())
+		throw Exc(F(t_("Wrong variable '%s' with values '%s'"), var, values));
+}
+
+int FASTCaseMatrix::GetCount() const {
+	if (vars.IsEmpty())
+		return 0;
+	int num = 1;
+	for (const Var &v : vars)
+		num *= v.values.size();
+	return num;
+}
+
+static void ListCaseFiles(const String &folder, const String &rel, const String &exclude, UVector<String> &files, UVector<String> &folders) {
+	for (FindFile ff(AFX(folder, rel, "*")); ff; ff.Next()) {
+		String name = rel.IsEmpty() ? ff.GetName() : AFX(rel, ff.GetName());
+		if (ff.IsFolder()) {
+			if (NormalizePath(ff.GetPath()) == exclude)
+				continue;
+			folders << name;
+			ListCaseFiles(folder, name, exclude, files, folders);
+		} else if (ff.IsFile() && !PatternMatchMulti("*.out*;*.txt;*.dbg", ff.GetName()))
+			files << name;
+	}
+}
+
+// Hard links the file, or copies it if the file system does not support links
+static bool FileLinkOrCopy(const String &from, const String &to, bool &linked) {
+	FileDelete(to);
+	std::error_code ec;
+	std::filesystem::create_hard_link(std::filesystem::u8path(~from), std::filesystem::u8path(~to), ec);
+	linked = !ec;
+	return linked || FileCopy(from, to);
+}
+
+String FASTCaseMatrix::Create(String seed, String folder, int numThreads, Function <bool(String, int)> Status) {
+	numWritten = numLinked = numCopied = 0;
+	try {
+		int num = GetCount();
+		if (num == 0)
+			throw Exc(t_("No variables in the case matrix"));
+		if (IsNull(numThreads))
+			numThreads = CPU_Cores();
+		numThreads = minmax(numThreads, 1, num);
+		
+		FASTCase cas;
+		String seedFolder;
+		if (DirectoryExists(seed)) {
+			FindFile ffpath(AFX(seed, "*.fst"));
+			if (!ffpath) 
+				throw Exc(F(t_("No .fst file found in folder '%s'"), seed));
+			seedFolder = seed;
+			cas.Load(ffpath.GetPath());
+		} else if (ToLower(GetFileExt(seed)) == ".fst") {
+			seedFolder = GetFileFolder(seed);
+			cas.Load(seed);
+		} else if (ToLower(GetFileExt(seed)) == ".dat") {
+			for (const Var &v : vars)
+				if (v.idFile != vars[0].idFile)
+					throw Exc(t_("With a .dat seed, all the variables have to be in the same file"));
+			seedFolder = GetFileFolder(seed);
+			GetFile(cas, vars[0].idFile).fileName = seed;
+		} else
+			throw Exc(F(t_("Wrong seed '%s'. It has to be a .fst or .dat file, or a folder"), seed));
+		
+		seedFolder = NormalizePath(seedFolder);
+		folder = NormalizePath(folder);
+		if (folder == seedFolder)
+			throw Exc(t_("The case folder cannot be the seed folder"));
+		
+		// The files with variables are loaded and checked once
+		UVector<int> idFiles;
+		UVector<String> relFiles;
+		for (const Var &v : vars) {
+			FASTCase::File &file = GetFile(cas, v.idFile);
+			if (file.fileName.IsEmpty())
+				throw Exc(F(t_("No %s file in seed '%s'"), fileTypes[v.idFile], seed));
+			file.GetString(v.name);		// Throws if the variable is not found
+			if (FindIndex(idFiles, v.idFile) < 0) {
+				String name = NormalizePath(file.fileName);
+				if (!name.StartsWith(seedFolder + DIR_SEPS))
+					throw Exc(F(t_("File '%s' is not in seed folder '%s'"), file.fileName, seedFolder));
+				idFiles << v.idFile;
+				relFiles << name.Mid(seedFolder.GetCount() + 1);
+			}
+		}
+		
+		UVector<String> files, folders;
+		ListCaseFiles(seedFolder, "", folder, files, folders);
+		for (int i = files.size()-1; i >= 0; --i)
+			if (FindIndex(relFiles, files[i]) >= 0)
+				files.Remove(i);
+		
+		int digits = FormatInt(num).GetCount();
+		auto GetCaseName = [&](int ic) {
+			String name = FormatInt(ic+1);
+			return "case_" + String('0', digits - name.GetCount()) + name;
+		};
+		auto GetValueId = [&](int ic, int iv) {		// The last variable changes faster
+			for (int i = vars.size()-1; i > iv; --i)
+				ic /= vars[i].values.size();
+			return ic%vars[iv].values.size();
+		};
+		
+		std::atomic<int> numLinked0(0), numCopied0(0);
+		auto CreateCase = [&](int ic) {
+			String folderCase = AFX(folder, GetCaseName(ic));
+			if (!RealizeDirectory(folderCase))
+				throw Exc(F(t_("Impossible to create folder %s"), folderCase));
+			for (const String &f : folders)
+				if (!RealizeDirectory(AFX(folderCase, f)))
+					throw Exc(F(t_("Impossible to create folder %s"), AFX(folderCase, f)));
+			
+			for (int i = 0; i < idFiles.size(); ++i) {
+				FASTCase::File file(GetFile(cas, idFiles[i]), 0);
+				for (int iv = 0; iv < vars.size(); ++iv) {
+					const Var &v = vars[iv];
+					if (v.idFile != idFiles[i])
+						continue;
+					const String &val = v.values[GetValueId(ic, iv)];
+					String lval = ToLower(val);
+					const char *endptr;						// The whole value has to be a number, so "12mps_s1.bts" is a string
+					bool isNum = !IsNull(ScanDouble(val, &endptr)) && *endptr == '\0';
+					if (val.StartsWith("\"") || isNum || lval == "true" || lval == "false")
+						file.SetValue(v.name, val);
+					else
+						file.SetString(v.name, val);
+				}
+				file.fileName = AFX(folderCase, relFiles[i]);
+				file.Save();
+			}
+			for (const String &f : files) {
+				bool linked;
+				if (!FileLinkOrCopy(AFX(seedFolder, f), AFX(folderCase, f), linked))
+					throw Exc(F(t_("Impossible to copy '%s' to '%s'"), AFX(seedFolder, f), folderCase));
+				if (linked)
+					numLinked0++;
+				else
+					numCopied0++;
+			}
+		};
+		
+		// The cases are created by a bounded number of threads, as the work is mainly disk access
+		std::atomic<int> next(0), done(0), running(numThreads);
+		std::atomic<bool> cancel(false);
+		Mutex mutex;
+		String error;
+		UArray<Thread> threads;
+		for (int it = 0; it < numThreads; ++it) 
+			threads.Add().Run([&] {
+				try {
+					while (!cancel) {
+						int ic = next++;
+						if (ic >= num)
+							break;
+						CreateCase(ic);
+						done++;
+					}
+				} catch (Exc e) {
+					Mutex::Lock __(mutex);
+					if (error.IsEmpty())
+						error = e;
+					cancel = true;
+				}
+				running--;
+			});
+		while (running > 0) {
+			try {
+				if (Status && !Status(F(t_("Creating case %d/%d"), int(done), num), 100*done/num))
+					cancel = true;
+			} catch (Exc e) {		// The threads have to finish before leaving
+				Mutex::Lock __(mutex);
+				if (error.IsEmpty())
+					error = e;
+				cancel = true;
+			}
+			Sleep(50);
+		}
+		for (Thread &t : threads)
+			t.Wait();
+		
+		if (!error.IsEmpty())
+			throw Exc(error);
+		if (cancel)
+			throw Exc(t_("Cancelled by the user"));
+		
+		numWritten = num*idFiles.size();
+		numLinked = numLinked0;
+		numCopied = numCopied0;
+		
+		const String &sep = Bem().csvSeparator;
+		String str = "case" + sep + "folder";
+		for (const Var &v : vars)
+			str << sep << fileTypes[v.idFile] << ":" << v.name;
+		for (int ic = 0; ic < num; ++ic) {
+			str << "\n" << (ic+1) << sep << GetCaseName(ic);
+			for (int iv = 0; iv < vars.size(); ++iv)
+				str << sep << vars[iv].values[GetValueId(ic, iv)];
+		}
+		if (!SaveFile(AFX(folder, "manifest.csv"), str))
+			throw Exc(F(t_("Impossible to save '%s'"), AFX(folder, "manifest.csv")));
+	} catch (Exc e) {
+		return e;
+	}
+	return String();
+}
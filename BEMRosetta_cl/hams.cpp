@@ -415,7 +415,7 @@ void Hams::SaveFolder0(String folderBase, bool bin, int numCases, bool deleteFol
 	UVector<int> valsf;
 	int ifr = 0;
 	if (numCases > 1)  
-		valsf = NumSets(dt.Nf, numCases);
+		valsf = GetCaseSets(numCases, irregular, 0);
 	
 	String solvName = !ismrel ? "HAMS_x64.exe" : "HAMS_MREL.exe";
 	if (bin) {
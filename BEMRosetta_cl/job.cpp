@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2020 - 2024, the BEMRosetta author and contributors
+#include "BEMRosetta.h"
+
+
+bool BackgroundJob::OnStatus(String str, int _pos) {
+	if (cancel)
+		throw Exc(t_("Cancelled by the user"));
+	
+	Mutex::Lock __(mutex);
+	if (!IsNull(str))
+		text = str;
+	pos = _pos;
+	changed = true;
+	return true;
+}
+
+void BackgroundJob::Start(Task task) {
+	ASSERT(!running && !thread.IsOpen());
+	
+	running = true;
+	thread.Run([this, task = pick(task)] {
+		try {
+			task([&](String str, int _pos) {return OnStatus(str, _pos);});
+		} catch (const Exc &e) {
+			Mutex::Lock __(mutex);
+			error = e;
+		} catch (...) {
+			Mutex::Lock __(mutex);
+			error = t_("Unknown error");
+		}
+		running = false;
+	});
+}
+
+void BackgroundJob::Wait() {
+	if (thread.IsOpen())
+		thread.Wait();
+}
+
+bool BackgroundJob::GetProgress(String &_text, int &_pos) {
+	Mutex::Lock __(mutex);
+	if (!changed)
+		return false;
+	_text = text;
+	_pos = pos;
+	changed = false;
+	return true;
+}
+
+void BackgroundJob::Check() {
+	if (cancel)
+		throw Exc(t_("Cancelled by the user"));
+	Mutex::Lock __(mutex);
+	if (!error.IsEmpty())
+		throw Exc(error);
+}
+
+void BackgroundJob::Run(Task task, StatusFun Status, Event<> WhenIdle) {
+	Start(pick(task));
+	
+	String str;
+	int _pos;
+	while (running) {
+		if (GetProgress(str, _pos) && Status && !Status(str, _pos))
+			Cancel();
+		if (WhenIdle)
+			WhenIdle();
+		else
+			Sleep(20);
+	}
+	Wait();
+	if (GetProgress(str, _pos) && Status)
+		Status(str, _pos);
+	Check();
+}
@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2020 - 2024, the BEMRosetta author and contributors
+#ifndef _BEMRosetta_cl_job_h_
+#define _BEMRosetta_cl_job_h_
+
+#include <atomic>
+
+// Runs a loading or processing task in a worker thread, while the caller keeps its own loop alive.
+// The task gets the usual Status(String, int pos) callback. Progress is handed to the caller thread,
+// and once cancelled, Status throws so that the task stops at its next progress report.
+// The task has to work on its own data, that the caller takes only after Run() returns.
+// A BackgroundJob runs just one task
+class BackgroundJob {
+public:
+	typedef Function <bool(String, int)> StatusFun;
+	typedef Function <void(StatusFun)> Task;
+	
+	BackgroundJob() {}
+	~BackgroundJob()						{Cancel(); Wait();}
+	
+	// Starts the task and waits for it, calling Status in this thread with the last progress. 
+	// If Status returns false the task is cancelled. Throws the task error, or if cancelled
+	void Run(Task task, StatusFun Status = Null, Event<> WhenIdle = Null);
+	
+	void Start(Task task);
+	void Wait();
+	void Check();							// Throws the task error, or if cancelled
+	
+	void Cancel()							{cancel = true;}	// It may be called before Start()
+	bool IsCanceled() const					{return cancel;}
+	bool IsRunning() const					{return running;}
+	
+	bool GetProgress(String &text, int &pos);	// true if there is new progress since last call
+	
+private:
+	Thread thread;
+	std::atomic<bool> running{false}, cancel{false};
+	Mutex mutex;
+	String text, error;
+	int pos = Null;
+	bool changed = false;
+	
+	bool OnStatus(String str, int _pos);
+};
+
+#endif
@@ -68,6 +68,7 @@ void Mooring::Vessel::Jsonize(JsonIO &json) {
 }
 
 bool Mooring::Load(String file) {
+	pointIndex.Clear();
 	try {
 		if (!LoadFromJsonFile(*this, ~file))
 			return false;
@@ -189,6 +190,7 @@ bool Mooring::LoadMoordyn(String file) {
 	lineTypes = pick(lT);
 	lineProperties = pick(lP);	
 	connections = pick(connect);
+	pointIndex.Clear();
 	
 	return true;
 }
@@ -359,11 +361,12 @@ Mooring::LineType &Mooring::GetLineType(String name) {
 	throw Exc(t_(F("Line type '%s' is not found", name)));
 }
 
-bool Mooring::FindClosest(Mooring::ClosestInfo &info) {
-	auto Distance3D = [](double x1, double y1, double z1, double x2, double y2, double z2)->double {
-	    return ::sqrt(sqr(x2 - x1) + sqr(y2 - y1) + sqr(z2 - z1));
-	};
-	
+static inline double Distance3D(double x1, double y1, double z1, double x2, double y2, double z2) {
+    return ::sqrt(sqr(x2 - x1) + sqr(y2 - y1) + sqr(z2 - z1));
+}
+
+// Reference implementation, comparing every pair of points
+bool Mooring::FindClosestBruteForce(Mooring::ClosestInfo &info) {
 	auto DistanceClosestConnector = [&](double x, double y, double z)->double {
 		double mind = std::numeric_limits<double>::max();
 		for (Connection &c : connections) 
@@ -371,11 +374,6 @@ bool Mooring::FindClosest(Mooring::ClosestInfo &info) {
 		return mind;
 	};
 	
-	if (lineProperties.IsEmpty()) {
-		info.distance = Null;
-		return false;
-	}
-	
 	info.distance = std::numeric_limits<double>::max();
 
     for(int i = 0; i < lineProperties.size(); i++) {
@@ -410,10 +408,343 @@ bool Mooring::FindClosest(Mooring::ClosestInfo &info) {
     return true;
 }
 
+void Mooring::BuildIndex() {
+	PointIndex &idx = pointIndex;
+	idx.Clear();
+	
+	double spacing = 0;
+	int nspacing = 0;
+	for (int il = 0; il < lineProperties.size(); ++il) {
+		const LineProperty &line = lineProperties[il];
+		for (int ip = 0; ip < line.x.size(); ++ip) {
+			if (ip > 0) {
+				spacing += Distance3D(line.x[ip-1], line.y[ip-1], line.z[ip-1], line.x[ip], line.y[ip], line.z[ip]);
+				nspacing++;
+			}
+			double mind = std::numeric_limits<double>::max();
+			for (const Connection &c : connections) 
+				mind = min(mind, Distance3D(line.x[ip], line.y[ip], line.z[ip], c.p.x, c.p.y, c.p.z));
+			if (mind > 10) {											// Discards closest connector
+				idx.pos << Point3D(line.x[ip], line.y[ip], line.z[ip]);
+				idx.line << il;
+				idx.point << ip;
+			}
+		}
+	}
+	idx.cell = nspacing > 0 ? max(1., spacing/nspacing) : 1.;
+	if (idx.pos.IsEmpty())
+		return;
+	
+	idx.pmin = idx.pos[0];
+	Point3D pmax = idx.pos[0];
+	for (const Point3D &p : idx.pos) {
+		idx.pmin.x = min(idx.pmin.x, p.x);	pmax.x = max(pmax.x, p.x);
+		idx.pmin.y = min(idx.pmin.y, p.y);	pmax.y = max(pmax.y, p.y);
+		idx.pmin.z = min(idx.pmin.z, p.z);	pmax.z = max(pmax.z, p.z);
+	}
+	idx.cell = max(idx.cell, max(pmax.x - idx.pmin.x, max(pmax.y - idx.pmin.y, pmax.z - idx.pmin.z))/(1 << 20));	// Keys have 21 bits per axis
+	idx.GetCell(pmax, idx.nx, idx.ny, idx.nz);
+	idx.nx++;	idx.ny++;	idx.nz++;
+	
+	for (int i = 0; i < idx.pos.size(); ++i) {
+		int ix, iy, iz;
+		idx.GetCell(idx.pos[i], ix, iy, iz);
+		idx.cells.GetAdd(PointIndex::Key(ix, iy, iz)) << i;
+	}
+}
+
+// Searches the cells around each point in growing shells, until they are farther than the closest distance found.
+// Ties are resolved as in FindClosestBruteForce(), so the results are the same
+bool Mooring::FindClosest(Mooring::ClosestInfo &info, bool bruteForce) {
+	if (lineProperties.IsEmpty()) {
+		info.distance = Null;
+		return false;
+	}
+	if (bruteForce)
+		return FindClosestBruteForce(info);
+	
+	if (pointIndex.IsEmpty())
+		BuildIndex();
+	const PointIndex &idx = pointIndex;
+	
+	info.distance = std::numeric_limits<double>::max();
+	
+	auto Check = [&](int i, int j) {
+		if (idx.line[i] > idx.line[j])
+			Swap(i, j);
+		const Point3D &a = idx.pos[i], &b = idx.pos[j];
+		double dist = Distance3D(a.x, a.y, a.z, b.x, b.y, b.z);
+		if (dist > info.distance)
+			return;
+		if (dist == info.distance) {		// Brute force keeps the first one, in line1, line2, point1, point2 order
+			int l1 = idx.line[i], l2 = idx.line[j], p1 = idx.point[i], p2 = idx.point[j];
+			if (l1 != info.line1 ? l1 > info.line1 : l2 != info.line2 ? l2 > info.line2 : p1 != info.point1 ? p1 > info.point1 : p2 > info.point2)
+				return;
+		}
+		info.distance = dist;
+		info.line1 = idx.line[i];
+		info.point1 = idx.point[i];
+		info.line2 = idx.line[j];
+		info.point2 = idx.point[j];
+	};
+	
+	auto Visit = [&](int i, int ix, int iy, int iz) {
+		int id = idx.cells.Find(PointIndex::Key(ix, iy, iz));
+		if (id < 0)
+			return;
+		for (int j : idx.cells[id]) 
+			if (j > i && idx.line[j] != idx.line[i])	// Each pair is checked from its first point
+				Check(i, j);
+	};
+	
+	int maxr = max(idx.nx, max(idx.ny, idx.nz));
+	for (int i = 0; i < idx.pos.size(); ++i) {
+		int cx, cy, cz;
+		idx.GetCell(idx.pos[i], cx, cy, cz);
+		for (int r = 0; r < maxr && (r-1)*idx.cell <= info.distance; ++r) {	// Points in shell r are at least (r-1)*cell away
+			for (int ix = max(cx - r, 0); ix <= min(cx + r, idx.nx - 1); ++ix) 
+				for (int iy = max(cy - r, 0); iy <= min(cy + r, idx.ny - 1); ++iy) {
+					if (abs(ix - cx) == r || abs(iy - cy) == r) {
+						for (int iz = max(cz - r, 0); iz <= min(cz + r, idx.nz - 1); ++iz) 
+							Visit(i, ix, iy, iz);
+					} else if (r > 0) {						// Only the shell faces
+						if (cz - r >= 0)
+							Visit(i, ix, iy, cz - r);
+						if (cz + r < idx.nz)
+							Visit(i, ix, iy, cz + r);
+					}
+				}
+		}
+	}
+    if (info.distance == std::numeric_limits<double>::max()) {
+        info.distance = Null;
+        return false;
+    }
+    return true;
+}
+
+// Shared anchor farm layout with 3 lines per floater, comparing the indexed and the brute force searches
+String Mooring::BenchmarkClosest(int maxLines) {
+	String ret = F("%6s %12s %12s %10s", t_("Lines"), t_("Index [s]"), t_("Brute [s]"), t_("Dist. [m]"));
+	for (int numLines = 6; numLines <= maxLines; numLines *= 2) {
+		Mooring moor;
+		moor.depth = 200;
+		int nFloaters = (numLines + 2)/3;
+		int side = int(ceil(sqrt(double(nFloaters))));
+		double spacing = 1000, radius = 600;
+		for (int ifl = 0; ifl < nFloaters; ++ifl) {
+			Point3D fl((ifl%side)*spacing, (ifl/side)*spacing, -20);
+			Connection &cf = moor.connections.Add();
+			cf.name = F("F%d", ifl);
+			cf.p = fl;
+			for (int k = 0; k < 3 && moor.lineProperties.size() < numLines; ++k) {
+				double ang = k*2*M_PI/3 + (ifl%2)*M_PI/3;
+				Point3D an(fl.x + radius*cos(ang), fl.y + radius*sin(ang), -moor.depth);
+				Connection &ca = moor.connections.Add();
+				ca.name = F("A%d_%d", ifl, k);
+				ca.p = an;
+				LineProperty &line = moor.lineProperties.Add();
+				line.name = F("L%d", moor.lineProperties.size());
+				line.from = cf.name;
+				line.to = ca.name;
+				int np = 51;
+				for (int ip = 0; ip < np; ++ip) {
+					double s = ip/(np - 1.);
+					line.x << fl.x + s*(an.x - fl.x);
+					line.y << fl.y + s*(an.y - fl.y);
+					line.z << fl.z + (an.z - fl.z)*sqrt(s);
+				}
+			}
+		}
+		ClosestInfo ci, cb;
+		TimeStop t;
+		moor.BuildIndex();
+		bool okIndex = moor.FindClosest(ci);
+		double tIndex = t.Seconds();
+		t.Reset();
+		bool okBrute = moor.FindClosest(cb, true);
+		double tBrute = t.Seconds();
+		if (okIndex != okBrute || (okIndex && (ci.distance != cb.distance || ci.line1 != cb.line1 || ci.point1 != cb.point1 ||
+											   ci.line2 != cb.line2 || ci.point2 != cb.point2)))
+			throw Exc(F(t_("Closest points differ for %d lines"), numLines));
+		ret << "\n" << F("%6d %12.4f %12.4f %10.3f", numLines, tIndex, tBrute, okIndex ? ci.distance : 0.);
+		
+		// Moves the middle point of the first line next to the second one, so the index has to be rebuilt
+		LineProperty &l0 = moor.lineProperties[0];
+		const LineProperty &l1 = moor.lineProperties[1];
+		int im = l0.x.size()/2;
+		l0.x[im] = l1.x[im] + 0.5;
+		l0.y[im] = l1.y[im];
+		l0.z[im] = l1.z[im];
+		moor.ClearIndex();
+		if (!moor.FindClosest(ci) || !moor.FindClosest(cb, true) || ci.distance != cb.distance || ci.distance > 0.5)
+			throw Exc(F(t_("Closest points differ for %d lines after moving a point"), numLines));
+	}
+	return ret;
+}
+
+bool Mooring::GetVesselLoads(int iv, const VectorXd &pos, VectorXd &f, double rho_water, double rho_m3) const {
+	const Vessel &vessel = vessels[iv];
+	
+	double cx = cos(pos(3)), sx = sin(pos(3)), cy = cos(pos(4)), sy = sin(pos(4)), cz = cos(pos(5)), sz = sin(pos(5));
+	Matrix3d R;			// Rz*Ry*Rx
+	R << cz*cy, cz*sy*sx - sz*cx, cz*sy*cx + sz*sx,
+		 sz*cy, sz*sy*sx + cz*cx, sz*sy*cx - cz*sx,
+		 -sy,   cy*sx,            cy*cx;
+	Vector3d ref(vessel.dx + pos(0), vessel.dy + pos(1), pos(2));
+	
+	auto GetEnd = [&](const Connection &c)->Vector3d {
+		int id = FindVessel(c.where);
+		if (id < 0)
+			return Vector3d(c.p.x, c.p.y, c.p.z);
+		return Vector3d(c.p.x + vessels[id].dx, c.p.y + vessels[id].dy, c.p.z);
+	};
+	
+	f = VectorXd::Zero(6);
+	UVector<double> vpos, z;
+	for (const LineProperty &line : lineProperties) {
+		const Connection &from = GetConnection(line.from);
+		const Connection &to = GetConnection(line.to);
+		bool isFrom = from.where == vessel.name;
+		if (!isFrom && to.where != vessel.name)
+			continue;
+		const Connection &fair = isFrom ? from : to;
+		if (IsNull(from.p) || IsNull(to.p))
+			return false;
+		
+		const LineType *linetype = nullptr;
+		for (const LineType &type : lineTypes) 
+			if (type.name == line.nameType) {
+				linetype = &type;
+				break;
+			}
+		if (!linetype)
+			throw Exc(t_(F("Line type '%s' is not found", line.nameType)));
+		
+		Vector3d pf = R*Vector3d(fair.p.x, fair.p.y, fair.p.z) + ref;
+		Vector3d pa = GetEnd(isFrom ? to : from);
+		Vector2d dir(pa(0) - pf(0), pa(1) - pf(1));
+		double xanchorvessel = dir.norm();
+		if (xanchorvessel > 0)
+			dir /= xanchorvessel;
+		
+		double fanchorvessel, fVanchor, fVvessel, lenonfloor;
+		MooringStatus status = Catenary(linetype->mass, rho_m3, rho_water, line.length, linetype->bl, 
+						xanchorvessel, pa(2) + depth, pf(2) + depth, fanchorvessel, fVanchor, fVvessel, 
+						lenonfloor, vpos, z, 2);	// Only the forces are used, so the line is hardly discretized
+		if (status == CALCULATION_PROBLEM)
+			return false;
+		
+		Vector3d force(fanchorvessel*dir(0), fanchorvessel*dir(1), -fVvessel);	// Pulls the vessel to the anchor and downwards
+		f.head<3>() += force;
+		f.tail<3>() += (pf - ref).cross(force);
+	}
+	return true;
+}
+
+MatrixXd Mooring::GetVesselLoads(int iv, const MatrixXd &pos, double rho_water, double rho_m3) const {
+	if (iv < 0 || iv >= vessels.size())
+		throw Exc(F(t_("Vessel %d not found"), iv));
+	if (pos.cols() != 6)
+		throw Exc(t_("Offsets have to include the 6 degrees of freedom"));
+	
+	MatrixXd ret(pos.rows(), 6);
+	CoPartition(0, int(pos.rows()), [&](int i0, int i1) {
+		VectorXd f;
+		for (int i = i0; i < i1; ++i) {
+			if (GetVesselLoads(iv, pos.row(i).transpose(), f, rho_water, rho_m3))
+				ret.row(i) = f.transpose();
+			else
+				ret.row(i).setConstant(Null);
+		}
+	});
+	return ret;
+}
+
+// Linearised mooring stiffness by central differences, K(i, j) = -dF(i)/dx(j)
+MatrixXd Mooring::GetStiffness(int iv, double rho_water, double dpos, double drot, double rho_m3) const {
+	MatrixXd pos = MatrixXd::Zero(12, 6);
+	for (int j = 0; j < 6; ++j) {
+		double d = j < 3 ? dpos : drot;
+		pos(2*j, j) = d;
+		pos(2*j+1, j) = -d;
+	}
+	MatrixXd f = GetVesselLoads(iv, pos, rho_water, rho_m3);
+	
+	MatrixXd K(6, 6);
+	for (int j = 0; j < 6; ++j) {
+		if (IsNull(f(2*j, 0)) || IsNull(f(2*j+1, 0)))
+			throw Exc(F(t_("Mooring lines could not be solved for displacement in dof %d"), j+1));
+		K.col(j) = -(f.row(2*j) - f.row(2*j+1)).transpose()/(2*pos(2*j, j));
+	}
+	return K;
+}
+
+// Offsets in a 10 m circle, as Calc() only moves the vessels horizontally. 
+// The loads from Calc() are the sum of the forces of the lines solved for the whole mooring
+String Mooring::BenchmarkLoads(int iv, double rho_water, int num) {
+	if (iv < 0 || iv >= vessels.size())
+		throw Exc(F(t_("Vessel %d not found"), iv));
+	if (IsNull(num) || num < 1)
+		throw Exc(F(t_("Wrong number of offsets %d"), num));
+	
+	MatrixXd pos = MatrixXd::Zero(num, 6);
+	for (int i = 0; i < num; ++i) {
+		double ang = 2*M_PI*i/num;
+		pos(i, 0) = 10*cos(ang);
+		pos(i, 1) = 10*sin(ang);
+	}
+	
+	TimeStop t;
+	MatrixXd f = GetVesselLoads(iv, pos, rho_water);
+	double tLoads = t.Seconds();
+	
+	Vessel &vessel = vessels[iv];
+	double dx = vessel.dx, dy = vessel.dy;
+	MatrixXd fCalc = MatrixXd::Zero(num, 3);
+	t.Reset();
+	for (int i = 0; i < num; ++i) {
+		vessel.dx = dx + pos(i, 0);
+		vessel.dy = dy + pos(i, 1);
+		Calc(rho_water);
+		for (const LineProperty &line : lineProperties) {
+			if (GetConnection(line.from).where != vessel.name && GetConnection(line.to).where != vessel.name)
+				continue;
+			if (line.status == CALCULATION_PROBLEM)
+				throw Exc(F(t_("Line '%s' could not be solved"), line.name));
+			fCalc(i, 0) += line.fanchorvessel*cos(line.theta);		// theta points from the vessel to the anchor
+			fCalc(i, 1) += line.fanchorvessel*sin(line.theta);
+			fCalc(i, 2) -= line.fVvessel;
+		}
+	}
+	double tCalc = t.Seconds();
+	vessel.dx = dx;
+	vessel.dy = dy;
+	Calc(rho_water);
+	
+	double maxf = 0, maxDiff = 0;
+	for (int i = 0; i < num; ++i) {
+		if (IsNull(f(i, 0)))
+			throw Exc(F(t_("Mooring lines could not be solved for offset %d"), i+1));
+		for (int j = 0; j < 3; ++j) {
+			maxf = max(maxf, abs(fCalc(i, j)));
+			maxDiff = max(maxDiff, abs(f(i, j) - fCalc(i, j)));
+		}
+	}
+	if (maxDiff > 1E-4*maxf)
+		throw Exc(F(t_("Loads differ from the ones from Calc() by %f N"), maxDiff));
+	
+	String ret = F(t_("Loads of vessel '%s' for %d offsets. Max. difference %g N"), vessel.name, num, maxDiff);
+	ret << "\n" << F(t_("GetVesselLoads(): %.4f s"), tLoads);
+	ret << "\n" << F(t_("Calc():           %.4f s"), tCalc);
+	return ret;
+}
+
 bool Mooring::Calc(double rho_water, int num, double rho_m3) {
 	if (IsNull(num) || num <= 0)
 		return false;
 	
+	pointIndex.Clear();
 	for (LineProperty &line : lineProperties) {
 		UVector<double> vpos;
 		
@@ -481,6 +812,7 @@ bool Mooring::Calc(double rho_water, int num, double rho_m3) {
 				line.theta += M_PI;
 		}
 	}
+	BuildIndex();
 	return true;
 }
 	
@@ -459,7 +459,7 @@ void Nemoh::SaveFolder0(String folderBase, bool bin, int numCases, bool deleteFo
 	UVector<int> valsf;
 	int ifr = 0;
 	if (numCases > 1) 
-		valsf = NumSets(dt.Nf, numCases);
+		valsf = GetCaseSets(numCases, irregular, qtfType);
 	
 	String binResults = AFX(folderBase, "bin");
 	if (!DirectoryCreateX(binResults))
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2020 - 2024, the BEMRosetta author and contributors
+#include "BEMRosetta.h"
+#include <random>
+
+using namespace Upp;
+
+#include "FastOut.h"
+
+
+// Peaks and valleys of the series, including the first and last points. Null and NaN samples are skipped
+static void GetReversals(const VectorXd &data, UVector<double> &rev) {
+	rev.Clear();
+	for (Eigen::Index i = 0; i < data.size(); ++i) {
+		double v = data(i);
+		if (IsNull(v) || !IsNum(v))
+			continue;
+		int num = rev.size();
+		if (num > 0 && v == rev[num-1])
+			continue;
+		if (num >= 2 && (rev[num-1] - rev[num-2])*(v - rev[num-1]) > 0)
+			rev[num-1] = v;			// Same direction, so the last point is not a reversal
+		else
+			rev << v;
+	}
+}
+
+void Rainflow(const VectorXd &data, UVector<double> &ranges, UVector<double> &means, UVector<double> &counts) {
+	ranges.Clear();
+	means.Clear();
+	counts.Clear();
+
+	UVector<double> rev;
+	GetReversals(data, rev);
+
+	auto AddCycle = [&](double a, double b, double count) {
+		ranges << abs(a - b);
+		means << (a + b)/2;
+		counts << count;
+	};
+
+	// ASTM E1049-85, 5.4.4. The stack keeps the reversals not yet counted
+	UVector<double> s;
+	for (double v : rev) {
+		s << v;
+		int num;
+		while ((num = s.size()) >= 3) {
+			double X = abs(s[num-1] - s[num-2]);
+			double Y = abs(s[num-2] - s[num-3]);
+			if (X < Y)
+				break;
+			if (num == 3) {			// Y includes the starting point, so it is a half cycle
+				AddCycle(s[0], s[1], 0.5);
+				s.Remove(0);
+			} else {
+				AddCycle(s[num-3], s[num-2], 1);
+				s.Remove(num-3, 2);
+			}
+		}
+	}
+	for (int i = 0; i < s.size()-1; ++i)	// The residue is counted as half cycles
+		AddCycle(s[i], s[i+1], 0.5);
+}
+
+double GetDEL(const UVector<double> &ranges, const UVector<double> &counts, double m, double neq) {
+	if (IsNull(m) || m <= 0)
+		throw Exc(F(t_("Wrong Wöhler exponent %f"), m));
+	if (IsNull(neq) || neq <= 0)
+		throw Exc(F(t_("Wrong number of equivalent cycles %f"), neq));
+
+	double damage = 0;
+	for (int i = 0; i < ranges.size(); ++i)
+		damage += counts[i]*pow(ranges[i], m);
+	return pow(damage/neq, 1/m);
+}
+
+double GetDEL(const VectorXd &data, double m, double neq) {
+	UVector<double> ranges, means, counts;
+	Rainflow(data, ranges, means, counts);
+	return GetDEL(ranges, counts, m, neq);
+}
+
+String BenchmarkRainflow(int num, double &astmCycles) {
+	// ASTM E1049-85 Fig. 6 series, and its counts by range in Table 4
+	VectorXd astm(9);
+	astm << -2, 1, -3, 5, -1, 3, -4, 4, -2;
+	const double astmRanges[] = {3, 4, 6, 8, 9};
+	const double astmCounts[] = {0.5, 1.5, 0.5, 1, 0.5};
+
+	UVector<double> ranges, means, counts;
+	Rainflow(astm, ranges, means, counts);
+	astmCycles = 0;
+	for (int i = 0; i < 5; ++i) {
+		double count = 0;
+		for (int ic = 0; ic < ranges.size(); ++ic)
+			if (ranges[ic] == astmRanges[i])
+				count += counts[ic];
+		if (count != astmCounts[i])
+			throw Exc(F(t_("ASTM E1049 range %.0f has %.1f cycles instead of %.1f"), astmRanges[i], count, astmCounts[i]));
+		astmCycles += count;
+	}
+	if (Sum(counts) != astmCycles)
+		throw Exc(t_("ASTM E1049 series has cycles of other ranges"));
+
+	// Irregular series, as the sum of harmonics with a fixed seed, so the results are repeatable
+	VectorXd data(num);
+	std::mt19937 rng(2024);
+	std::uniform_real_distribution<double> phase(0, 2*M_PI);
+	const int numHarm = 20;
+	double ph[numHarm];
+	for (int ih = 0; ih < numHarm; ++ih)
+		ph[ih] = phase(rng);
+	for (int i = 0; i < num; ++i) {
+		double t = i*0.05;
+		data(i) = 0;
+		for (int ih = 0; ih < numHarm; ++ih)
+			data(i) += sin((0.2 + 0.1*ih)*t + ph[ih])/(1 + ih);
+	}
+
+	TimeStop t;
+	Rainflow(data, ranges, means, counts);
+	double tRainflow = t.Seconds();
+	t.Reset();
+	double del = GetDEL(ranges, counts, 4, num*0.05);
+	double tDel = t.Seconds();
+
+	String ret = F(t_("ASTM E1049 reference cycles found: %.1f"), astmCycles);
+	ret << "\n" << F(t_("%d samples, %.1f cycles. DEL(m=4, 1 Hz) %f"), num, Sum(counts), del);
+	ret << "\n" << F(t_("Rainflow: %.3f s, %.1f Msamples/s"), tRainflow, num/max(tRainflow, 1E-9)/1E6);
+	ret << "\n" << F(t_("DEL:      %.3f s"), tDel);
+	return ret;
+}
@@ -0,0 +1,210 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2020 - 2024, the BEMRosetta author and contributors
+#include "BEMRosetta.h"
+
+#ifdef PLATFORM_LINUX
+#include <sched.h>
+#endif
+
+
+static void ListFiles(const String &folder, const String &rel, const String &pattern, UVector<String> &files) {
+	for (FindFile ff(AFX(folder, rel, "*")); ff; ff.Next()) {
+		String name = rel.IsEmpty() ? ff.GetName() : AFX(rel, ff.GetName());
+		if (ff.IsFolder())
+			ListFiles(folder, name, pattern, files);
+		else if (ff.IsFile() && PatternMatchMulti(pattern, ff.GetName()))
+			files << name;
+	}
+}
+
+void CaseRunner::ListFiles(String folder, String pattern, UVector<String> &files) {
+	::ListFiles(folder, "", pattern, files);
+	Sort(files);
+}
+
+// The process environment, with the thread count of the usual parallel libraries set to numThreads
+static String GetRunEnvironment(int numThreads) {
+	const Index<String> vars = {"OMP_NUM_THREADS", "MKL_NUM_THREADS", "OPENBLAS_NUM_THREADS", "NUMBA_NUM_THREADS"};
+
+	String env;
+	const VectorMap<String, String> &envs = Environment();
+	for (int i = 0; i < envs.GetCount(); ++i) {
+		if (vars.Find(ToUpper(envs.GetKey(i))) >= 0)
+			continue;
+		env << envs.GetKey(i) << "=" << envs[i];
+		env.Cat('\0');
+	}
+	for (const String &var : vars) {
+		env << var << "=" << numThreads;
+		env.Cat('\0');
+	}
+	env.Cat('\0');
+	return env;
+}
+
+// Threads created by the process after this call are also pinned
+static void SetRunAffinity(LocalProcess &process, int core0, int num) {
+	int cores = CPU_Cores();
+#if defined(PLATFORM_WIN32)
+	cores = min(cores, int(8*sizeof(DWORD_PTR)));
+	DWORD_PTR mask = 0;
+	for (int i = 0; i < num; ++i)
+		mask |= DWORD_PTR(1) << ((core0 + i)%cores);
+	SetProcessAffinityMask(process.GetProcessHandle(), mask);
+#elif defined(PLATFORM_LINUX)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (int i = 0; i < num; ++i)
+		CPU_SET((core0 + i)%cores, &set);
+	sched_setaffinity(process.GetPid(), sizeof(set), &set);
+#endif
+}
+
+String CaseRunner::Run(String folder, String pattern, String command, Function <bool(String, int)> Status) {
+	cases.Clear();
+	numRun = numSkipped = numFailed = numTimeout = 0;
+	seconds = 0;
+
+	struct Running {
+		int id, slot;
+		LocalProcess process;
+		FileOut out;
+		TimeStop t;
+	};
+	UArray<Running> running;
+
+	try {
+		if (!DirectoryExists(folder))
+			throw Exc(F(t_("Folder '%s' not found"), folder));
+		if (IsNull(numThreads) || numThreads < 1)
+			throw Exc(F(t_("Wrong number of threads %d"), numThreads));
+		int jobs = IsNull(numJobs) ? max(1, CPU_Cores()/numThreads) : numJobs;
+		if (jobs < 1)
+			throw Exc(F(t_("Wrong number of jobs %d"), jobs));
+
+		UVector<String> files;
+		ListFiles(folder, pattern, files);
+		if (files.IsEmpty())
+			throw Exc(F(t_("No '%s' file found in '%s'"), pattern, folder));
+
+		// Log of the finished cases, as <exit code>\t<seconds>\t<file>
+		String logFile = AFX(folder, "BEMRosetta_run.log");
+		Index<String> done;
+		if (resume) {
+			for (const String &line : Split(LoadFile(logFile), '\n')) {
+				UVector<String> data = Split(line, '\t', false);
+				if (data.size() == 3 && ScanInt(data[0]) == 0)
+					done.FindAdd(TrimRight(data[2]));
+			}
+		} else
+			FileDelete(logFile);
+		FileAppend log(logFile);
+		if (!log.IsOpen())
+			throw Exc(F(t_("Impossible to open file '%s'"), logFile));
+
+		UVector<int> pending;
+		for (const String &file : files) {
+			Case &c = cases.Add();
+			c.file = file;
+			if (done.Find(file) >= 0) {
+				c.skipped = true;
+				numSkipped++;
+			} else
+				pending << cases.size()-1;
+		}
+
+		if (command == "script") {
+#ifdef PLATFORM_WIN32
+			command = "cmd /c \"%file%\"";
+#else
+			command = "sh \"%file%\"";
+#endif
+		} else if (command.Find("%file%") < 0)
+			command << " \"%file%\"";
+		command.Replace("%threads%", FormatInt(numThreads));
+		String env = GetRunEnvironment(numThreads);
+
+		UVector<bool> slots(jobs, false);
+		TimeStop total, tStatus;
+		int next = 0;
+		bool changed = true;
+		while (next < pending.size() || !running.IsEmpty()) {
+			while (next < pending.size() && running.size() < jobs) {
+				Running &r = running.Add();
+				r.id = pending[next++];
+				r.slot = FindIndex(slots, false);
+				slots[r.slot] = true;
+
+				String file = AFX(folder, cases[r.id].file);
+				String cmd = command;
+				cmd.Replace("%file%", GetFileName(file));
+				if (!r.out.Open(file + ".log"))
+					throw Exc(F(t_("Impossible to open file '%s'"), file + ".log"));
+				if (!r.process.Start(cmd, ~env, GetFileFolder(file)))
+					throw Exc(F(t_("Problem launching '%s'"), cmd));
+				if (affinity)
+					SetRunAffinity(r.process, r.slot*numThreads, numThreads);
+				changed = true;
+			}
+			for (int i = running.size()-1; i >= 0; --i) {
+				Running &r = running[i];
+				Case &c = cases[r.id];
+				String reso, rese;
+				bool isRunning = r.process.Read2(reso, rese);
+				r.out << reso << rese;
+				if (isRunning && !IsNull(timeout) && r.t.Seconds() > timeout) {
+					r.process.Kill();
+					c.timeout = true;
+					isRunning = false;
+				}
+				if (isRunning)
+					continue;
+
+				c.seconds = r.t.Seconds();
+				numRun++;
+				if (c.timeout)
+					numTimeout++;
+				else
+					c.exitCode = r.process.GetExitCode();
+				if (c.exitCode != 0)
+					numFailed++;
+				log << (c.timeout ? String("timeout") : FormatInt(c.exitCode)) << "\t" << FDS(c.seconds, 6) << "\t" << c.file << "\n";
+				log.Flush();
+
+				slots[r.slot] = false;
+				running.Remove(i);
+				changed = true;
+			}
+			if (Status && (changed || tStatus.Seconds() > 1)) {
+				double sec = total.Seconds();
+				String str = F(t_("%d/%d cases, %d running, %d failed. %.2f cases/min"),
+								numRun, pending.size(), running.size(), numFailed, 60*numRun/max(sec, 1E-9));
+				if (numRun > 0)
+					str << F(t_(", %.0f s left"), sec/numRun*(pending.size() - numRun));
+				if (!Status(str, 100*numRun/pending.size()))
+					throw Exc(t_("Cancelled by the user"));
+				changed = false;
+				tStatus.Reset();
+			}
+			Sleep(20);
+		}
+		seconds = total.Seconds();
+	} catch (Exc e) {
+		for (Running &r : running)		// They are not logged, so a resumed run starts them again
+			r.process.Kill();
+		return e;
+	}
+	return String();
+}
+
+String CaseRunner::GetSummary() const {
+	String ret = F(t_("Cases: %d run, %d skipped, %d failed, %d timed out"), numRun, numSkipped, numFailed, numTimeout);
+	ret << "\n" << F(t_("Time: %.1f s, %.2f cases/min"), seconds, 60*numRun/max(seconds, 1E-9));
+	for (const Case &c : cases) {
+		if (c.timeout)
+			ret << "\n" << F(t_("'%s' timed out after %.1f s"), c.file, c.seconds);
+		else if (!c.skipped && !IsNull(c.exitCode) && c.exitCode != 0)
+			ret << "\n" << F(t_("'%s' ended with exit code %d"), c.file, c.exitCode);
+	}
+	return ret;
+}
@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2020 - 2024, the BEMRosetta author and contributors
+#ifndef _BEMRosetta_cl_runner_h_
+#define _BEMRosetta_cl_runner_h_
+
+// Runs the solver or OpenFAST cases of a folder as local processes, several at a time.
+// Every finished case is appended to BEMRosetta_run.log in the folder, so an interrupted run resumes with the cases left
+class CaseRunner {
+public:
+	struct Case {
+		String file;				// Relative to the run folder
+		int exitCode = Null;
+		double seconds = Null;
+		bool timeout = false;
+		bool skipped = false;
+	};
+
+	// Runs command for every file matching pattern in folder and its subfolders, in the file folder.
+	// In command, %file% and %threads% are replaced. Without %file% the file name is appended.
+	// If command is "script", the file is run as a script
+	String Run(String folder, String pattern, String command, Function <bool(String, int)> Status = Null);
+
+	int numJobs = Null;				// Cases running at the same time. By default, the cores divided by numThreads
+	int numThreads = 1;				// Threads per case, set in OMP_NUM_THREADS and similar
+	bool affinity = false;			// Pins every running case to its own numThreads cores
+	double timeout = Null;			// Maximum seconds per case
+	bool resume = true;				// Skips the cases that ended right in a previous run
+
+	int numRun = 0, numSkipped = 0, numFailed = 0, numTimeout = 0;
+	double seconds = 0;
+
+	const UArray<Case> &GetCases() const	{return cases;}
+	String GetSummary() const;
+	
+	// Files matching pattern in folder and its subfolders, relative to folder and sorted
+	static void ListFiles(String folder, String pattern, UVector<String> &files);
+
+private:
+	UArray<Case> cases;
+};
+
+#endif
@@ -10,7 +10,7 @@
 using namespace Eigen;
 
 
-String Wind::Load(String _fileName, String ext) {
+String Wind::Load(String _fileName, String ext, bool stream) {
 	const UVector<String> extStr = {".bts", ".wnd"};
 	UVector<String> extS;
 	
@@ -39,7 +39,7 @@ String Wind::Load(String _fileName, String ext) {
 			file = fileName + eext;
 		if (FileExists(file)) {
 			if (eext == ".bts") {
-				if(IsEmpty(ret = static_cast<BTSWind&>(*this).LoadBTS(file)))
+				if(IsEmpty(ret = static_cast<BTSWind&>(*this).LoadBTS(file, stream)))
 					break;	
 			} else if (eext == ".wnd") {
 				if(IsEmpty(ret = static_cast<WNDWind&>(*this).LoadWND(file)))
@@ -127,6 +127,7 @@ void Wind::Report(Grid &grid) const {
 	grid.SetRow({"Hub height", 			"m", 	Grid::Nvl(zHub, F("%.1f", zHub))});
 	grid.SetRow({"Z bottom grid", 		"m", 	Grid::Nvl(zGrid, F("%.2f", zGrid))});
 	grid.SetRow({"Wind type", 			"", 	fc > 0 ? String(GetWindTypeStr()) : String()});
+	grid.SetRow({"Memory", 				"", 	IsStreamed() ? String(t_("Streamed from file")) : FormatFileSize(int64(sizeof(float))*(velocity.size() + twrVelocity.size()))});
 }
 
 
@@ -135,24 +136,191 @@ void Wind::GetPos(double z, double y, int &idz, int &idy) {
 	idy = FindClosest(yPos, y);
 }
 
-VectorXd Wind::GetNorm(int idz, int idy) {
-	VectorXd ret(nt);
-	
-	for (int it = 0; it < nt; ++it)
-		ret(it) = Norm(velocity(it, 0, idy, idz), velocity(it, 1, idy, idz), velocity(it, 2, idy, idz));
+static void CheckTimeWindow(int nt, int it0, int &num) {
+	if (IsNull(num))
+		num = nt - it0;
+	if (it0 < 0 || num < 0 || it0 + num > nt)
+		throw Exc(F(t_("Time steps %d to %d are out of range (%d)"), it0, it0 + num, nt));
+}
+
+VectorXd Wind::GetNorm(int idz, int idy, int it0, int num) {
+	CheckTimeWindow(nt, it0, num);
 	
+	VectorXd ret(num);
+	if (IsStreamed()) {
+		for (int it = 0; it < num; ++it)
+			ret(it) = Norm(double(Vel(it0 + it, 0, idy, idz)), double(Vel(it0 + it, 1, idy, idz)), double(Vel(it0 + it, 2, idy, idz)));
+	} else {
+		const float *u = &velocity(it0, 0, idy, idz),		// Time series are contiguous
+					*v = &velocity(it0, 1, idy, idz),
+					*w = &velocity(it0, 2, idy, idz);
+		for (int it = 0; it < num; ++it)
+			ret(it) = Norm(double(u[it]), double(v[it]), double(w[it]));
+	}
 	return ret;
 }
 
-VectorXd Wind::Get(int ic, int idz, int idy) {
-	if (ic >= velocity.dimension(1))
+VectorXd Wind::Get(int ic, int idz, int idy, int it0, int num) {
+	if (ic >= nffc)
 		throw Exc(F(t_("Component %d is not available"), ic+1));
+	CheckTimeWindow(nt, it0, num);
 	
-	VectorXd ret(nt);
+	if (IsStreamed()) {
+		VectorXd ret(num);
+		for (int it = 0; it < num; ++it)
+			ret(it) = Vel(it0 + it, ic, idy, idz);
+		return ret;
+	}
+	return Map<const VectorXf>(&velocity(it0, ic, idy, idz), num).cast<double>();
+}
+
+// Decodes all the streamed data, so that it can be modified
+void Wind::Expand() {
+	if (!IsStreamed())
+		return;
+	
+	Tensor<float, 4> vel(nt, 3, ny, nz);
+	Tensor<float, 3> twr(nt, 3, ntwr);
+	for (int it = 0; it < nt; ++it) {
+		for (int iz = 0; iz < nz; ++iz)
+			for (int iy = 0; iy < ny; ++iy)
+				for (int k = 0; k < 3; ++k)
+					vel(it, k, iy, iz) = Vel(it, k, iy, iz);
+		for (int itw = 0; itw < ntwr; ++itw)
+			for (int k = 0; k < 3; ++k)
+				twr(it, k, itw) = TwrVel(it, k, itw);
+	}
+	btsMap.Clear();
+	btsData = nullptr;
+	velocity = pick(vel);
+	twrVelocity = pick(twr);
+}
+
+static void GetCell(const VectorXd &pos, double d, double x, int &id, float &w) {
+	int n = int(pos.size());
+	if (n < 2) {
+		id = 0;
+		w = 0;
+		return;
+	}
+	double r = (x - pos(0))/d;
+	id = minmax(int(floor(r)), 0, n-2);
+	w = float(minmax(r - id, 0., 1.));
+}
+
+// Time series of component ic, bilinearly interpolated in y, z
+void Wind::GetSeries(int ic, double y, double z, ArrayXf &ret) const {
+	int iy, iz;
+	float wy, wz;
+	GetCell(yPos, dy, y, iy, wy);
+	GetCell(zPos, dz, z, iz, wz);
+	int iy1 = min(iy+1, ny-1), iz1 = min(iz+1, nz-1);
+	float w00 = (1-wy)*(1-wz), w10 = wy*(1-wz), w01 = (1-wy)*wz, w11 = wy*wz;
 	
-	for (int it = 0; it < nt; ++it)
-		ret(it) = velocity(it, ic, idy, idz);
+	if (IsStreamed()) {
+		ret.resize(nt);
+		for (int it = 0; it < nt; ++it)
+			ret(it) = w00*Vel(it, ic, iy, iz)  + w10*Vel(it, ic, iy1, iz) + 
+					  w01*Vel(it, ic, iy, iz1) + w11*Vel(it, ic, iy1, iz1);
+	} else {
+		auto S = [&](int jy, int jz) {return Map<const ArrayXf>(&velocity(0, ic, jy, jz), nt);};
+		ret = w00*S(iy, iz) + w10*S(iy1, iz) + w01*S(iy, iz1) + w11*S(iy1, iz1);
+	}
+}
+
+void Wind::GetTimeWeights(const VectorXd &time, ArrayXi &its, ArrayXf &wts) const {
+	if (time.size() == 0) {
+		its = ArrayXi::LinSpaced(nt, 0, nt-1);
+		wts = ArrayXf::Zero(nt);
+		return;
+	}
+	its.resize(time.size());
+	wts.resize(time.size());
+	for (int i = 0; i < time.size(); ++i) {
+		double r = time(i)/dt;
+		its(i) = nt < 2 ? 0 : minmax(int(floor(r)), 0, nt-2);
+		wts(i) = nt < 2 ? 0 : float(minmax(r - its(i), 0., 1.));
+	}
+}
+
+static inline double SampleTime(const ArrayXf &s, const ArrayXi &its, const ArrayXf &wts, int i) {
+	int it = its(i);
+	float w = wts(i);
+	return w == 0 ? s(it) : (1-w)*s(it) + w*s(it+1);
+}
+
+MatrixXd Wind::Interpolate(int ic, const VectorXd &y, const VectorXd &z, const VectorXd &time) const {
+	if (y.size() != z.size())
+		throw Exc(t_("y and z must have the same size"));
+	if (ic >= nffc || ic < -1)
+		throw Exc(F(t_("Component %d is not available"), ic+1));
+	if (ic == -1 && nffc < 3)
+		throw Exc(F(t_("The velocity norm requires 3 components and the file has %d"), nffc));
+	
+	ArrayXi its;
+	ArrayXf wts;
+	GetTimeWeights(time, its, wts);
 	
+	MatrixXd ret(y.size(), its.size());
+	CoPartition(0, int(y.size()), [&](int ip0, int ip1) {
+		ArrayXf s, u, v, w;
+		for (int ip = ip0; ip < ip1; ++ip) {
+			if (ic >= 0)
+				GetSeries(ic, y(ip), z(ip), s);
+			else {
+				GetSeries(0, y(ip), z(ip), u);
+				GetSeries(1, y(ip), z(ip), v);
+				GetSeries(2, y(ip), z(ip), w);
+				s = (u.square() + v.square() + w.square()).sqrt();
+			}
+			for (int i = 0; i < its.size(); ++i)
+				ret(ip, i) = SampleTime(s, its, wts, i);
+		}
+	});
+	return ret;
+}
+
+// Rotor equivalent wind speed, (Σ Ai·vi³/A)^(1/3), with vi the velocity normal to the yawed disc
+// projected on the grid plane. The disc is sampled in nr equal area rings and na angles
+MatrixXd Wind::GetRotorEquivalent(const VectorXd &y, const VectorXd &z, const VectorXd &radius, const VectorXd &yaw, 
+								  const VectorXd &time, int nr, int na) const {
+	if (y.size() != z.size() || y.size() != radius.size() || y.size() != yaw.size())
+		throw Exc(t_("y, z, radius and yaw must have the same size"));
+	if (nr < 1 || na < 1)
+		throw Exc(t_("Wrong number of rotor disc samples"));
+	for (int ip = 0; ip < yaw.size(); ++ip)
+		if (sin(ToRad(yaw(ip))) != 0 && nffc < 2)
+			throw Exc(F(t_("Yawed rotors require the lateral component and the file has %d components"), nffc));
+	
+	ArrayXi its;
+	ArrayXf wts;
+	GetTimeWeights(time, its, wts);
+	
+	MatrixXd ret(y.size(), its.size());
+	CoPartition(0, int(y.size()), [&](int ip0, int ip1) {
+		ArrayXf acc, u, v;
+		for (int ip = ip0; ip < ip1; ++ip) {
+			double cy = cos(ToRad(yaw(ip))), sy = sin(ToRad(yaw(ip)));
+			acc = ArrayXf::Zero(nt);
+			for (int ir = 0; ir < nr; ++ir) {
+				double r = radius(ip)*sqrt((ir + 0.5)/nr);
+				for (int ia = 0; ia < na; ++ia) {
+					double th = 2*M_PI*ia/na;
+					double yp = y(ip) + r*cos(th)*cy, 
+						   zp = z(ip) + r*sin(th);
+					GetSeries(0, yp, zp, u);
+					if (sy != 0) {
+						GetSeries(1, yp, zp, v);
+						u = u*float(cy) + v*float(sy);
+					}
+					acc += u.cube();
+				}
+			}
+			acc /= float(nr*na);
+			for (int i = 0; i < its.size(); ++i)
+				ret(ip, i) = std::cbrt(SampleTime(acc, its, wts, i));
+		}
+	});
 	return ret;
 }
 
@@ -172,55 +340,151 @@ void Wind::SetTI(int uvw, float ti, float &tiOld, float offset) {
 	if (uvw >= nffc)
 		throw Exc(F(t_("Component %d is higher than available components %d"), uvw, nffc));
 	
-	ASSERT(nt   == velocity.dimension(0));
-	ASSERT(nffc == velocity.dimension(1));
-	ASSERT(ny   == velocity.dimension(2));
-	ASSERT(nz   == velocity.dimension(3));
-	
-	for (int it = 0; it < nt; ++it) {
-	    for (int iz = 0; iz < nz; ++iz)
-	        for (int iy = 0; iy < ny; ++iy) 
-	            velocity(it,uvw,iy,iz) = (velocity(it,uvw,iy,iz) - offset)*(ti/tiOld) + offset;
-	}
+	float a = ti/tiOld;		// (v - offset)*a + offset
+	Transform(uvw, VectorXf::Constant(nz, a), VectorXf::Constant(nz, offset*(1 - a)));
 	tiOld = ti;       
 }
 
 void Wind::SetPowerLaw(float pl, float zh) {
-	ASSERT(nt   == velocity.dimension(0));
-	ASSERT(nffc == velocity.dimension(1));
-	ASSERT(ny   == velocity.dimension(2));
-	ASSERT(nz   == velocity.dimension(3));
 	ASSERT(nz	== zPos.size());
-	
 	ASSERT(nffc > 0);	// At least 1 component, u
 	int ic = 0;			// Only for u component
 	
-	for (int it = 0; it < nt; ++it) 
-	    for (int iz = 0; iz < nz; ++iz)
-	        for (int iy = 0; iy < ny; ++iy) 
-	            velocity(it,ic,iy,iz) += mffws * (pow(zPos[iz]/zh, pl) - 1);
+	VectorXf delta(nz);
+	for (int iz = 0; iz < nz; ++iz) 
+		delta(iz) = float(mffws * (pow(zPos[iz]/zh, pl) - 1));
+	Transform(ic, VectorXf::Ones(nz), delta);
 }
 
 void Wind::SetFactor(float fu, float fv, float fw) {
+	bool queued = IsTransformQueued();
+	if (!queued)
+		BeginTransform();
 	SetFactor(0, fu);
 	SetFactor(1, fv);
 	SetFactor(2, fw);
+	if (!queued)
+		ApplyTransform();
 }
 
 void Wind::SetFactor(int ic, float f) {
 	if (ic >= nffc)
 		return;
 	
+	Transform(ic, VectorXf::Constant(nz, f), VectorXf::Zero(nz));
+}
+
+// All transforms are v = a*v + b, with a and b depending on the component and the height.
+// When queued, they are combined so that the field is modified in a single pass
+void Wind::Transform(int ic, const VectorXf &a, const VectorXf &b) {
+	if (IsTransformQueued()) {
+		trA.row(ic) = trA.row(ic).cwiseProduct(a.transpose());
+		trB.row(ic) = trB.row(ic).cwiseProduct(a.transpose()) + b.transpose();
+		trUsed[ic] = true;
+	} else {
+		BeginTransform();
+		Transform(ic, a, b);
+		ApplyTransform();
+	}
+}
+
+void Wind::BeginTransform() {
+	trA = MatrixXf::Ones(3, nz);
+	trB = MatrixXf::Zero(3, nz);
+	trUsed.Clear();
+	trUsed.SetCount(3, false);
+}
+
+bool Wind::ApplyTransform() {
+	if (!IsTransformQueued())
+		return false;
+	
+	MatrixXf a = pick(trA), b = pick(trB);
+	UVector<bool> used = pick(trUsed);
+	trA.resize(0, 0);
+	trUsed.Clear();
+	
+	if (FindIndex(used, true) < 0)
+		return false;
+	
+	Expand();
+	
 	ASSERT(nt   == velocity.dimension(0));
 	ASSERT(nffc == velocity.dimension(1));
 	ASSERT(ny   == velocity.dimension(2));
 	ASSERT(nz   == velocity.dimension(3));
-	ASSERT(nz	== zPos.size());	
 	
-	for (int it = 0; it < nt; ++it) 
-	    for (int iz = 0; iz < nz; ++iz)
-	        for (int iy = 0; iy < ny; ++iy) 
-	            velocity(it,ic,iy,iz) *= f;
+	CoPartition(0, nz, [&](int iz0, int iz1) {
+		for (int iz = iz0; iz < iz1; ++iz) 
+			for (int iy = 0; iy < ny; ++iy) 
+				for (int ic = 0; ic < nffc; ++ic) {
+					if (!used[ic])
+						continue;
+					Map<ArrayXf> v(&velocity(0, ic, iy, iz), nt);	// Time series are contiguous
+					v = v*a(ic, iz) + b(ic, iz);
+				}
+	});
+	return true;
+}
+
+// Applies a power law, a TI change and factors one after the other, and then queued in a single pass.
+// The model is left with the queued result
+String Wind::BenchmarkTransform(float pl, float zh, float factor, int &num) {
+	Expand();
+	
+	Tensor<float, 4> velocity0 = velocity;
+	float TI_U0 = TI_U;
+	auto Steps = [&]() {
+		SetPowerLaw(pl, zh);
+		if (TI_U > 0)
+			SetTI_u(TI_U*factor);
+		SetFactor(factor, 1/factor, factor);
+	};
+	
+	TimeStop t;
+	Steps();								// Each step is a pass over the field
+	double tSeq = t.Seconds();
+	Tensor<float, 4> velocitySeq = velocity;
+	
+	velocity = velocity0;
+	TI_U = TI_U0;
+	t.Reset();
+	BeginTransform();
+	Steps();
+	ApplyTransform();
+	double tFused = t.Seconds();
+	
+	num = int(velocity.size());
+	double maxDiff = 0, maxVel = 0;
+	for (Eigen::Index i = 0; i < velocity.size(); ++i) {
+		maxDiff = max(maxDiff, double(abs(velocity.data()[i] - velocitySeq.data()[i])));
+		maxVel  = max(maxVel,  double(abs(velocitySeq.data()[i])));
+	}
+	if (maxDiff > 1E-5*max(maxVel, 1.))
+		throw Exc(F(t_("Queued transforms differ from the sequential ones by %f m/s"), maxDiff));
+	
+	String ret = F(t_("%d values. Highest difference between queued and sequential transforms %g m/s"), num, maxDiff);
+	ret << "\n" << F(t_("Sequential: %.3f s"), tSeq);
+	ret << "\n" << F(t_("Queued:     %.3f s"), tFused);
+	return ret;
+}
+
+double Wind::GetMaxDifference(const Wind &w) const {
+	if (w.nt != nt || w.ny != ny || w.nz != nz || w.nffc != nffc)
+		throw Exc(t_("Wind fields have different grids or time steps"));
+	
+	UVector<double> maxDiff(nz, 0.);
+	CoPartition(0, nz, [&](int iz0, int iz1) {
+		for (int iz = iz0; iz < iz1; ++iz) 
+			for (int iy = 0; iy < ny; ++iy) 
+				for (int k = 0; k < nffc; ++k) 
+					for (int it = 0; it < nt; ++it) 
+						maxDiff[iz] = max(maxDiff[iz], abs(double(Vel(it, k, iy, iz)) - w.Vel(it, k, iy, iz)));
+	});
+	double ret = 0;
+	for (double d : maxDiff)
+		ret = max(ret, d);
+	return ret;
 }
 
 void ArrayWind::Report(Grid &grid) {
@@ -0,0 +1,288 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2020 - 2024, the BEMRosetta author and contributors
+#include "BEMRosetta.h"
+#include "BEMRosetta_int.h"
+
+#include <unsupported/Eigen/CXX11/Tensor>
+#include <unsupported/Eigen/FFT>
+#include <random>
+
+using namespace Eigen;
+
+
+// FFT of every detrended and Hann windowed segment of x, with 50% overlap. Columns are the segments
+static void SegmentFFT(FFT<double> &fft, const VectorXd &x, const VectorXd &win, MatrixXcd &X) {
+	int nfft = int(win.size());
+	int step = nfft/2;
+	int nseg = 1 + (int(x.size()) - nfft)/step;
+
+	X.resize(nfft/2 + 1, nseg);
+	VectorXd seg(nfft);
+	VectorXcd f;
+	for (int is = 0; is < nseg; ++is) {
+		seg = x.segment(is*step, nfft);
+		seg = (seg.array() - seg.mean())*win.array();
+		fft.fwd(f, seg);
+		X.col(is) = f.head(nfft/2 + 1);
+	}
+}
+
+// One-sided Welch power spectral density
+static void WelchPSD(const MatrixXcd &X, double fs, double winPow, VectorXd &psd) {
+	psd = X.cwiseAbs2().rowwise().mean()*(2/(fs*winPow));
+	psd(0) /= 2;
+	psd(psd.size()-1) /= 2;
+}
+
+// Integral time scale, as the integral of the autocorrelation up to its first zero crossing
+static double IntegralTime(FFT<double> &fft, const VectorXd &x, double dt) {
+	int n = int(x.size());
+	int n2 = 1;
+	while (n2 < 2*n)
+		n2 *= 2;
+	VectorXd xp = VectorXd::Zero(n2);
+	xp.head(n) = x.array() - x.mean();
+
+	VectorXcd f;
+	fft.fwd(f, xp);
+	f = f.cwiseAbs2().cast<std::complex<double>>();
+	VectorXd r;
+	fft.inv(r, f, n2);
+
+	if (r(0) <= 0)
+		return 0;
+	double T = 0;
+	for (int k = 1; k < n; ++k) {
+		double r0 = r(k-1)/r(0), r1 = r(k)/r(0);
+		if (r1 <= 0) {
+			T += dt*r0*r0/(r0 - r1)/2;		// Up to the linearly interpolated crossing
+			break;
+		}
+		T += dt*(r0 + r1)/2;
+	}
+	return T;
+}
+
+void Wind::GetSpectra(Spectra &sp, int ic, int nfft) const {
+	if (IsNull(nt) || nt < 16)
+		throw Exc(t_("Not enough time steps for spectral analysis"));
+	if (ic < 0 || ic >= nffc)
+		throw Exc(F(t_("Component %d is not available"), ic+1));
+	if (IsNull(nfft)) {
+		nfft = 16;
+		while (2*nfft <= nt/4)
+			nfft *= 2;
+	}
+	if (nfft < 4 || nfft > nt)
+		throw Exc(F(t_("Wrong FFT length %d. It has to be between 4 and %d"), nfft, nt));
+	nfft = nfft/2*2;
+
+	auto GetPoint = [&](int jc, int iy, int iz, VectorXd &s) {
+		if (IsStreamed()) {
+			s.resize(nt);
+			for (int it = 0; it < nt; ++it)
+				s(it) = Vel(it, jc, iy, iz);
+		} else
+			s = Map<const VectorXf>(&velocity(0, jc, iy, iz), nt).cast<double>();
+	};
+
+	double fs = 1/dt;
+	VectorXd win(nfft);
+	for (int i = 0; i < nfft; ++i)
+		win(i) = 0.5*(1 - cos(2*M_PI*i/nfft));
+	double winPow = win.squaredNorm();
+
+	int nf = nfft/2 + 1;
+	sp.ic = ic;
+	sp.nfft = nfft;
+	Arange(sp.freq, 0, nf-1);
+	sp.freq *= fs/nfft;
+
+	// Coherence is referred to the grid point closest to the hub
+	sp.iyRef = FindClosest(yPos, 0.);
+	sp.izRef = IsNull(zHub) ? nz/2 : FindClosest(zPos, double(zHub));
+	MatrixXcd Xref;
+	VectorXd psdRef;
+	{
+		FFT<double> fft;
+		fft.SetFlag(FFT<double>::HalfSpectrum);
+		VectorXd s;
+		GetPoint(ic, sp.iyRef, sp.izRef, s);
+		SegmentFFT(fft, s, win, Xref);
+		WelchPSD(Xref, fs, winPow, psdRef);
+	}
+
+	int np = ny*nz;
+	sp.psd.resize(nf, np);
+	sp.coh.resize(nf, np);
+	sp.variance.resize(np);
+	sp.psdVariance.resize(np);
+	sp.lengthScale.resize(np);
+	double df = fs/nfft;
+
+	CoPartition(0, np, [&](int ip0, int ip1) {
+		FFT<double> fft;			// Plans are cached, so one per thread
+		fft.SetFlag(FFT<double>::HalfSpectrum);
+		VectorXd s, u, psd;
+		MatrixXcd X;
+		for (int ip = ip0; ip < ip1; ++ip) {
+			int iy = ip%ny, iz = ip/ny;
+			GetPoint(ic, iy, iz, s);
+			SegmentFFT(fft, s, win, X);
+			WelchPSD(X, fs, winPow, psd);
+			sp.psd.col(ip) = psd;
+
+			VectorXcd Pxy = X.cwiseProduct(Xref.conjugate()).rowwise().mean()*(2/(fs*winPow));
+			for (int i = 0; i < nf; ++i) {
+				double den = psd(i)*psdRef(i);
+				sp.coh(i, ip) = den > 0 ? min(1., std::norm(Pxy(i))/den) : 0;
+			}
+
+			sp.variance(ip) = (s.array() - s.mean()).square().mean();
+			sp.psdVariance(ip) = psd.sum()*df;
+
+			if (ic == 0)		// Taylor's frozen turbulence hypothesis, advected with the mean longitudinal velocity
+				u = s;
+			else
+				GetPoint(0, iy, iz, u);
+			sp.lengthScale(ip) = u.mean()*IntegralTime(fft, s, dt);
+		}
+	});
+}
+
+// Synthetic field with a Kaimal spectrum (IEC 61400-1) of mean speed u, turbulence intensity ti [%] and integral length 
+// scale l in u at every grid point, with random phases. ti and l are then recovered fitting Kaimal to the PSD averaged over the grid
+String Wind::BenchmarkSpectra(double u, double ti, double l, double &tiCalc, double &lCalc) {
+	if (IsNull(u) || u <= 0 || IsNull(ti) || ti <= 0 || IsNull(l) || l <= 0)
+		throw Exc(F(t_("Wrong mean speed %f, TI %f or length scale %f"), u, ti, l));
+	
+	Wind w;
+	w.nt = 16384;
+	w.dt = 0.25f;
+	w.ny = w.nz = 5;
+	w.dy = w.dz = 10;
+	w.zGrid = 50;
+	w.nffc = 3;
+	w.ntwr = 0;
+	w.mffws = float(u);
+	w.SetYZ();
+	w.velocity = Tensor<float, 4>(w.nt, 3, w.ny, w.nz);
+	w.velocity.setZero();
+	
+	auto Kaimal = [&](double f, double ll, double sigma2) {
+		return sigma2*4*ll/u/pow(1 + 6*f*ll/u, 5/3.);
+	};
+	auto KaimalBelow = [&](double f, double ll) {		// Ratio of the variance below f
+		return 1 - pow(1 + 6*f*ll/u, -2/3.);
+	};
+	
+	// The harmonics are spaced 1/duration, finer than the PSD bins, so each bin averages several of them
+	int nh = w.nt/2;
+	double dfs = 1/(w.nt*double(w.dt)), sigma2 = sqr(ti*u/100);
+	VectorXd amp = VectorXd::Zero(nh);
+	for (int k = 1; k < nh; ++k) 
+		amp(k) = sqrt(2*Kaimal(k*dfs, l, sigma2)*dfs);
+	
+	std::mt19937 rng(2024);		// Phases from the engine output, as the std distributions are implementation defined
+	FFT<double> fft;
+	fft.SetFlag(FFT<double>::Unscaled);
+	VectorXcd z(w.nt);
+	VectorXd x;
+	for (int iz = 0; iz < w.nz; ++iz) 
+		for (int iy = 0; iy < w.ny; ++iy) {
+			z.setZero();
+			for (int k = 1; k < nh; ++k) {
+				z(k) = std::polar(amp(k)/2, 2*M_PI*(rng()/4294967296.));
+				z(w.nt - k) = std::conj(z(k));
+			}
+			fft.inv(x, z);
+			for (int it = 0; it < w.nt; ++it)
+				w.velocity(it, 0, iy, iz) = float(u + x(it));
+		}
+	
+	TimeStop t;
+	Spectra sp;
+	w.GetSpectra(sp, 0, 4096);
+	double tSpectra = t.Seconds();
+	
+	// The record only has the harmonics between 1/duration and Nyquist, so its variance is that band of the spectrum
+	VectorXd psd = sp.psd.rowwise().mean();
+	double variance = sp.variance.mean(), fN = sp.freq(sp.freq.size()-1);
+	auto Band = [&](double ll) {
+		return KaimalBelow(fN, ll) - KaimalBelow(dfs/2, ll);
+	};
+	// Least squares in log scale. The first and last bins are skipped, as they are halved
+	auto Error = [&](double logl) {
+		double ll = exp(logl), s2 = variance/Band(ll), err = 0;
+		for (int i = 1; i < psd.size()-1; ++i)
+			err += sqr(log(psd(i)) - log(Kaimal(sp.freq(i), ll, s2)));
+		return err;
+	};
+	// Golden section search of the length scale between 1 m and 10 km
+	const double g = (sqrt(5.) - 1)/2;
+	double a = 0, b = log(1E4), c = b - g*(b - a), d = a + g*(b - a), errc = Error(c), errd = Error(d);
+	while (b - a > 1E-8) {
+		if (errc < errd) {
+			b = d;
+			d = c;
+			errd = errc;
+			c = b - g*(b - a);
+			errc = Error(c);
+		} else {
+			a = c;
+			c = d;
+			errc = errd;
+			d = a + g*(b - a);
+			errd = Error(d);
+		}
+	}
+	lCalc = exp((a + b)/2);
+	tiCalc = 100*sqrt(variance/Band(lCalc))/u;
+	
+	if (abs(tiCalc - ti) > 0.02*ti)
+		throw Exc(F(t_("Recovered TI %f differs from %f"), tiCalc, ti));
+	if (abs(lCalc - l) > 0.05*l)
+		throw Exc(F(t_("Recovered length scale %f differs from %f"), lCalc, l));
+	
+	String ret = F(t_("Kaimal u %f m/s, TI %f, L %f m. Recovered TI %f, L %f m"), u, ti, l, tiCalc, lCalc);
+	ret << "\n" << F(t_("Spectra of %d points and %d time steps: %.3f s"), w.ny*w.nz, w.nt, tSpectra);
+	return ret;
+}
+
+String Wind::SaveSpectra(String fileName, int ic, int nfft) const {
+	try {
+		Spectra sp;
+		GetSpectra(sp, ic, nfft);
+
+		String base = AFX(GetFileFolder(fileName), GetFileTitle(fileName));
+		const String &sep = Bem().csvSeparator;
+		int np = ny*nz;
+
+		String head = "freq [Hz]";
+		for (int ip = 0; ip < np; ++ip)
+			head << sep << F("y%.2f_z%.2f", yPos(ip%ny), zPos(ip/ny));
+
+		auto SaveMatrix = [&](String file, const MatrixXd &m) {
+			String str = head;
+			for (int i = 0; i < m.rows(); ++i) {
+				str << "\n" << FDS(sp.freq(i), 10);
+				for (int ip = 0; ip < np; ++ip)
+					str << sep << FDS(m(i, ip), 10);
+			}
+			if (!SaveFile(file, str))
+				throw Exc(F(t_("Impossible to save '%s'"), file));
+		};
+		SaveMatrix(base + "_psd.csv", sp.psd);
+		SaveMatrix(base + "_coh.csv", sp.coh);
+
+		String str = "y [m]" + sep + "z [m]" + sep + "variance [m2/s2]" + sep + "psd variance [m2/s2]" + sep + "length scale [m]";
+		for (int ip = 0; ip < np; ++ip)
+			str << "\n" << FDS(yPos(ip%ny), 10) << sep << FDS(zPos(ip/ny), 10) << sep
+				<< FDS(sp.variance(ip), 10) << sep << FDS(sp.psdVariance(ip), 10) << sep << FDS(sp.lengthScale(ip), 10);
+		if (!SaveFile(base + "_stats.csv", str))
+			throw Exc(F(t_("Impossible to save '%s'"), base + "_stats.csv"));
+	} catch (Exc e) {
+		return e;
+	}
+	return String();
+}
@@ -234,7 +234,7 @@ String WNDWind::LoadWND(String fileName, double _zHub) {
 		if (LHR) 		// Bladed defined the v-component opposite of the right-hand rule...
 		    Scale[1] = -Scale[1];
 		
-		velocity = Tensor<double, 4>(nt,nffc,ny,nz);
+		velocity = Tensor<float, 4>(nt,nffc,ny,nz);
 		velocity.setZero();
 		
 		UVector<int> y_ix;
@@ -253,7 +253,7 @@ String WNDWind::LoadWND(String fileName, double _zHub) {
 		    for (int iz = 0; iz < nz; ++iz)
 		        for (int iy : y_ix)
 		            for (int k = 0; k < nffc; ++k)
-		                velocity(it,k,iy,iz) = v[cnt2++]*Scale[k] + Offset[k];
+		                velocity(it,k,iy,iz) = float(v[cnt2++]*Scale[k] + Offset[k]);
 		}
 	} catch(Exc e) {
 		return e;
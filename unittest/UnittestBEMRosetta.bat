@@ -53,10 +53,18 @@ copy .\.test\libbemrosetta.py ..\_bin
 @IF %ERRORLEVEL% NEQ 0 PAUSE "Error copying BEMRosetta"
 
 del /Q /F .\.test\TurbSim2.bts
+del /Q /F .\.test\TurbSim3.bts
 del /Q /F .\.test\hello.*
+del /Q /F .\.test\results*.*
+del /Q /F .\.test\join_*.h5
+del /Q /F .\.test\benchSave*.*
+del /Q /F .\.test\longNames.outb
+del /Q /F .\.test\stats_*.out
 del /Q /F .\.test\*.log
 del /Q /F .\.test\*.txt
 del /Q /F .\.test\*.csv
 del /Q /F .\.test\__pycache__\*.*
 rd  .\.test\__pycache__
+rd /S /Q .\.test\cases
+rd /S /Q .\.test\cache
 
@@ -21,4 +21,15 @@ umk BEMRosetta BEMRosetta    CLANG_17 -r +GUI,SHARED 	  ./.test/bemrosetta
 # umk BEMRosetta BEMRosetta    CLANG 	  -r +GUI,SHARED     ./.test/bemrosetta
 
 rm ./.test/TurbSim2.bts
+rm ./.test/TurbSim3.bts
+rm ./.test/TurbSim_spectra_*.csv
 rm ./.test/hello.*
+rm ./.test/results*
+rm ./.test/join_*.h5
+rm ./.test/benchSave*
+rm ./.test/longNames.outb
+rm ./.test/stats_*.out
+rm ./.test/stats.csv
+rm ./.test/stats_del.csv
+rm -r ./.test/cases
+rm -r ./.test/cache